@@ -193,3 +193,21 @@ void collectSubsectors(const std::unique_ptr<BSPNode>& root,
     collectLeavesRecursive(root, outSubsectors);
 }
 
+
+int flattenBSP(const BSPNode* node, std::vector<FlatBSPNode>& outNodes,
+               std::vector<Segment>& outSegments)
+{
+    if (!node) return -1;
+
+    int index = (int)outNodes.size();
+    outNodes.push_back({ node->splitA, node->splitB, -1, -1,
+                         (int32_t)outSegments.size(), (int32_t)node->onPlane.size() });
+    outSegments.insert(outSegments.end(), node->onPlane.begin(), node->onPlane.end());
+
+    // push_back may reallocate, only index outNodes after each call returns
+    int front = flattenBSP(node->front.get(), outNodes, outSegments);
+    int back = flattenBSP(node->back.get(), outNodes, outSegments);
+    outNodes[index].front = front;
+    outNodes[index].back = back;
+    return index;
+}
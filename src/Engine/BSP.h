@@ -1,6 +1,7 @@
 #ifndef BSP_H
 #define BSP_H
 
+#include <cstdint>
 #include <vector>
 #include <memory>
 #include "MapToSegments.h" // provides GridSegment
@@ -20,6 +21,17 @@ struct BSPNode {
     std::unique_ptr<BSPNode> back;
 };
 
+// Pointer-free node for baked levels. Children are indices into the node
+// array (-1 = none), on-plane segments a range of a shared segment array.
+struct FlatBSPNode {
+    Vec2 splitA;
+    Vec2 splitB;
+    int32_t front;
+    int32_t back;
+    int32_t firstSegment;
+    int32_t segmentCount;
+};
+
 /// Build a BSP tree from a list of segments. Returns root node (nullptr if no segments).
 std::unique_ptr<BSPNode> buildBSP(const std::vector<Segment>& segments);
 
@@ -27,5 +39,10 @@ std::unique_ptr<BSPNode> buildBSP(const std::vector<Segment>& segments);
 void collectSubsectors(const std::unique_ptr<BSPNode>& root,
                        std::vector<std::vector<Segment>>& outSubsectors);
 
+/// Flatten a tree depth-first into nodes/segments. Returns the index of
+/// node (the root lands at 0), -1 for a null node.
+int flattenBSP(const BSPNode* node, std::vector<FlatBSPNode>& outNodes,
+               std::vector<Segment>& outSegments);
+
 #endif // BSP_H
 
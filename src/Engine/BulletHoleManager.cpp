@@ -50,6 +50,10 @@ void BulletHoleManager::update(float dt) {
     }
 }
 
+void BulletHoleManager::clear() {
+    holes.clear();
+}
+
 void BulletHoleManager::spawn(
     int tileX,
     int tileY,
@@ -30,6 +30,7 @@ class BulletHoleManager
 public:
     bool loadVisual(BulletHoleType type, const std::string& path);
     void update(float dt);
+    void clear();
     void spawn(int tileX, int tileY, float playerZ, GridSegment::Dir dir, float hitFraction, BulletHoleType type);
 
     const std::vector<BulletHole>& getAll() const;
@@ -0,0 +1,130 @@
+#include "Collision.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    // A body touching a tile edge is not overlapping that tile
+    constexpr float EDGE_EPS = 1e-4f;
+}
+
+bool Collision::sweepX(const Map& map, float& x, float y, float dx,
+                       float radius, float feetZ, float stepHeight)
+{
+    if (dx == 0.0f)
+        return false;
+
+    int row0 = int(std::floor(y - radius + EDGE_EPS));
+    int row1 = int(std::ceil(y + radius - EDGE_EPS)) - 1;
+
+    if (dx > 0.0f) {
+        // Columns the leading edge sweeps into, nearest first
+        float lead = x + radius;
+        int col0 = int(std::ceil(lead - EDGE_EPS));
+        int col1 = int(std::ceil(lead + dx)) - 1;
+
+        for (int col = col0; col <= col1; col++) {
+            for (int row = row0; row <= row1; row++) {
+                if (blocks(map, col, row, feetZ, stepHeight)) {
+                    x = col - radius;
+                    return true;
+                }
+            }
+        }
+    } else {
+        float lead = x - radius;
+        int col0 = int(std::floor(lead + EDGE_EPS)) - 1;
+        int col1 = int(std::floor(lead + dx));
+
+        for (int col = col0; col >= col1; col--) {
+            for (int row = row0; row <= row1; row++) {
+                if (blocks(map, col, row, feetZ, stepHeight)) {
+                    x = col + 1 + radius;
+                    return true;
+                }
+            }
+        }
+    }
+
+    x += dx;
+    return false;
+}
+
+bool Collision::sweepY(const Map& map, float x, float& y, float dy,
+                       float radius, float feetZ, float stepHeight)
+{
+    if (dy == 0.0f)
+        return false;
+
+    int col0 = int(std::floor(x - radius + EDGE_EPS));
+    int col1 = int(std::ceil(x + radius - EDGE_EPS)) - 1;
+
+    if (dy > 0.0f) {
+        float lead = y + radius;
+        int row0 = int(std::ceil(lead - EDGE_EPS));
+        int row1 = int(std::ceil(lead + dy)) - 1;
+
+        for (int row = row0; row <= row1; row++) {
+            for (int col = col0; col <= col1; col++) {
+                if (blocks(map, col, row, feetZ, stepHeight)) {
+                    y = row - radius;
+                    return true;
+                }
+            }
+        }
+    } else {
+        float lead = y - radius;
+        int row0 = int(std::floor(lead + EDGE_EPS)) - 1;
+        int row1 = int(std::floor(lead + dy));
+
+        for (int row = row0; row >= row1; row--) {
+            for (int col = col0; col <= col1; col++) {
+                if (blocks(map, col, row, feetZ, stepHeight)) {
+                    y = row + 1 + radius;
+                    return true;
+                }
+            }
+        }
+    }
+
+    y += dy;
+    return false;
+}
+
+CollisionResult Collision::move(const Map& map, float x, float y, float dx, float dy,
+                                float radius, float feetZ, float stepHeight)
+{
+    CollisionResult r{ x, y };
+
+    float dist = std::max(std::fabs(dx), std::fabs(dy));
+    int steps = std::max(1, int(std::ceil(dist / MAX_SUBSTEP)));
+    float stepX = dx / steps;
+    float stepY = dy / steps;
+
+    // Once an axis hits something it stays put, the other keeps sliding
+    for (int i = 0; i < steps; i++) {
+        if (!r.blockedX)
+            r.blockedX = sweepX(map, r.x, r.y, stepX, radius, feetZ, stepHeight);
+        if (!r.blockedY)
+            r.blockedY = sweepY(map, r.x, r.y, stepY, radius, feetZ, stepHeight);
+    }
+
+    return r;
+}
+
+void Collision::moveBatch(const Map& map, CollisionBatch& batch, float radius, float stepHeight) {
+    float* xs = batch.x.data();
+    float* ys = batch.y.data();
+    const float* dxs = batch.dx.data();
+    const float* dys = batch.dy.data();
+    const float* feet = batch.feetZ.data();
+    uint8_t* blocked = batch.blocked.data();
+
+    int n = batch.size();
+    for (int i = 0; i < n; i++) {
+        CollisionResult r = move(map, xs[i], ys[i], dxs[i], dys[i], radius, feet[i], stepHeight);
+        xs[i] = r.x;
+        ys[i] = r.y;
+        blocked[i] = (r.blockedX ? CollisionBatch::BLOCKED_X : 0) |
+                     (r.blockedY ? CollisionBatch::BLOCKED_Y : 0);
+    }
+}
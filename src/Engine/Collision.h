@@ -0,0 +1,70 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "Map.h"
+
+// Many bodies moved in one pass. Struct-of-arrays so the resolve loop
+// streams through plain float arrays. x / y hold the start position going
+// in and the resolved position coming out.
+struct CollisionBatch {
+    enum : uint8_t { BLOCKED_X = 1 << 0, BLOCKED_Y = 1 << 1 };
+
+    std::vector<float> x, y;
+    std::vector<float> dx, dy;
+    std::vector<float> feetZ;
+    std::vector<uint8_t> blocked;
+
+    void clear() {
+        x.clear(); y.clear();
+        dx.clear(); dy.clear();
+        feetZ.clear();
+        blocked.clear();
+    }
+
+    // Returns the body's index in the batch
+    int add(float startX, float startY, float moveX, float moveY, float feet) {
+        x.push_back(startX);
+        y.push_back(startY);
+        dx.push_back(moveX);
+        dy.push_back(moveY);
+        feetZ.push_back(feet);
+        blocked.push_back(0);
+        return (int)x.size() - 1;
+    }
+
+    int size() const { return (int)x.size(); }
+};
+
+struct CollisionResult {
+    float x, y;
+    bool blockedX = false;
+    bool blockedY = false;
+};
+
+// Swept movement of round bodies against the tile grid, shared by the player,
+// enemies and projectiles. A body is a circle on the floor plane, tested
+// against tiles by its bounding square so it slides cleanly along walls. A
+// tile blocks when it rises more than stepHeight above the body's feet.
+// Moves are split into sub-steps of at most MAX_SUBSTEP and each axis
+// checks every tile column / row it sweeps, so a large dt can't tunnel.
+class Collision {
+public:
+    static constexpr float MAX_SUBSTEP = 0.5f;
+
+    static bool blocks(const Map& map, int tx, int ty, float feetZ, float stepHeight) {
+        return map.heightFast(tx, ty) > feetZ + stepHeight;
+    }
+
+    static CollisionResult move(const Map& map, float x, float y, float dx, float dy,
+                                float radius, float feetZ, float stepHeight);
+
+    // All bodies share radius and step height
+    static void moveBatch(const Map& map, CollisionBatch& batch, float radius, float stepHeight);
+
+private:
+    // Slide along one axis, returns true if a tile stopped the body
+    static bool sweepX(const Map& map, float& x, float y, float dx,
+                       float radius, float feetZ, float stepHeight);
+    static bool sweepY(const Map& map, float x, float& y, float dy,
+                       float radius, float feetZ, float stepHeight);
+};
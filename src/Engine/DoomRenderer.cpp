@@ -11,9 +11,9 @@ static constexpr float WALL_WORLD_HEIGHT = 1.0f; // world units for a full-heigh
 
 SpriteRenderer spriteRenderer;
 
-DoomRenderer::DoomRenderer(const std::vector<GridSegment>& segments,
-                           std::unique_ptr<BSPNode> bspRoot)
-    : m_segments(segments), m_bspRoot(std::move(bspRoot))
+DoomRenderer::DoomRenderer(std::vector<FlatBSPNode> nodes,
+                           std::vector<GridSegment> nodeSegments)
+    : m_nodes(std::move(nodes)), m_nodeSegments(std::move(nodeSegments))
 {
 }
 
@@ -306,7 +306,7 @@ void DoomRenderer::rasterizeSegment(const GridSegment& seg, int mapTileX, int ma
     if (x1 < x0) std::swap(x0, x1);
 
     // Wall heights for this tile
-    float tileH = map.get(mapTileX, mapTileY).height;
+    float tileH = map.heightAt(mapTileX, mapTileY);
     float floorZ = (tileH < 0.0f) ? tileH : 0.0f;
     float ceilZ = (tileH < 0.0f) ? 0.0f : tileH;
 
@@ -378,7 +378,7 @@ float DoomRenderer::sideOfLine(float ax, float ay, float bx, float by, float px,
 
 // traverse BSP front to back relative to player's position 
 void DoomRenderer::traverseBSP(
-    const BSPNode* node,
+    int nodeIndex,
     const Player& player,
     uint32_t* pixels,
     int screenW,
@@ -389,31 +389,36 @@ void DoomRenderer::traverseBSP(
     TextureManager& textureManager,
     BulletHoleManager& bulletHoleManager
 ) {
-    if (!node) return;
+    if (nodeIndex < 0) return;
+    const FlatBSPNode& node = m_nodes[nodeIndex];
 
     // Determine traversal order
     float side = sideOfLine(
-        node->splitA.x, node->splitA.y,
-        node->splitB.x, node->splitB.y,
+        node.splitA.x, node.splitA.y,
+        node.splitB.x, node.splitB.y,
         player.x, player.y
     );
 
-    const BSPNode* first = (side > 0.0f) ? node->front.get() : node->back.get();
-    const BSPNode* second = (side > 0.0f) ? node->back.get()  : node->front.get();
+    int first = (side > 0.0f) ? node.front : node.back;
+    int second = (side > 0.0f) ? node.back  : node.front;
+
+    const GridSegment* onPlane = m_nodeSegments.data() + node.firstSegment;
+    const GridSegment* onPlaneEnd = onPlane + node.segmentCount;
 
     // Traverse far side first
-    if (second)
+    if (second >= 0)
         traverseBSP(second, player, pixels, screenW, screenH, map, zBuffer, tileDrawn, textureManager, bulletHoleManager);
 
     // Pass 1: vertical walls only
-    for (const auto& seg : node->onPlane) {
+    for (const GridSegment* it = onPlane; it != onPlaneEnd; ++it) {
+        const GridSegment& seg = *it;
         int tx = seg.tileX;
         int ty = seg.tileY;
 
-        if (tx < 0 || tx >= Map::SIZE || ty < 0 || ty >= Map::SIZE)
+        if (!map.inBounds(tx, ty))
             continue;
 
-        const Map::Cell& cell = map.get(tx, ty);
+        const Map::Cell cell = map.getFast(tx, ty);
         float h = cell.height;
 
         const Texture* wallTex = nullptr;
@@ -435,27 +440,28 @@ void DoomRenderer::traverseBSP(
     }
 
     // Pass 2: floors, pits, wall tops
-    for (const auto& seg : node->onPlane) {
+    for (const GridSegment* it = onPlane; it != onPlaneEnd; ++it) {
+        const GridSegment& seg = *it;
         int tx = seg.tileX;
         int ty = seg.tileY;
 
-        if (tx < 0 || tx >= Map::SIZE || ty < 0 || ty >= Map::SIZE)
+        if (!map.inBounds(tx, ty))
             continue;
 
-        int idx = tx + ty * Map::SIZE;
+        int idx = tx + ty * map.width;
         if (tileDrawn[idx])
             continue;
-        if (map.get(tx+1,ty).height < 0 || map.get(tx,ty+1).height < 0 || map.get(tx,ty-1).height < 0 || map.get(tx-1,ty).height < 0 || map.get(tx+1,ty+1).height < 0 || map.get(tx-1,ty-1).height < 0) {
+        if (map.heightFast(tx+1,ty) < 0 || map.heightFast(tx,ty+1) < 0 || map.heightFast(tx,ty-1) < 0 || map.heightFast(tx-1,ty) < 0 || map.heightFast(tx+1,ty+1) < 0 || map.heightFast(tx-1,ty-1) < 0) {
             tileDrawn[idx] = false;
         }
-        else if (map.get(tx+2,ty).height < 0 || map.get(tx,ty+2).height < 0 || map.get(tx,ty-2).height < 0 || map.get(tx-2,ty).height < 0 || map.get(tx+2,ty+2).height < 0 || map.get(tx-2,ty-2).height < 0) {
+        else if (map.heightFast(tx+2,ty) < 0 || map.heightFast(tx,ty+2) < 0 || map.heightFast(tx,ty-2) < 0 || map.heightFast(tx-2,ty) < 0 || map.heightFast(tx+2,ty+2) < 0 || map.heightFast(tx-2,ty-2) < 0) {
             tileDrawn[idx] = false;
         }
         else {
             tileDrawn[idx] = true;
         }
 
-        const Map::Cell& cell = map.get(tx, ty);
+        const Map::Cell cell = map.getFast(tx, ty);
         float h = cell.height;
 
         const Texture* floorTex = nullptr;
@@ -486,7 +492,7 @@ void DoomRenderer::traverseBSP(
     }
 
     // Traverse near side last
-    if (first)
+    if (first >= 0)
         traverseBSP(first, player, pixels, screenW, screenH, map, zBuffer, tileDrawn, textureManager, bulletHoleManager);
 }
 
@@ -505,10 +511,10 @@ void DoomRenderer::render(uint32_t* pixels, int screenW, int screenH,
         zBuffer[x] = 1e6f;
 
     static std::vector<uint8_t> tileDrawn;
-    tileDrawn.assign(Map::SIZE * Map::SIZE, 0);
+    tileDrawn.assign(map.width * map.height, 0);
 
     // Traverse BSP and draw segments front-to-back
-    traverseBSP(m_bspRoot.get(), player, pixels, screenW, screenH, map, zBuffer, tileDrawn.data(), textureManager, bulletHoleManager);
+    traverseBSP(m_nodes.empty() ? -1 : 0, player, pixels, screenW, screenH, map, zBuffer, tileDrawn.data(), textureManager, bulletHoleManager);
 
     // Fill Ceiling
     for (int y = 0; y < screenH / 2; ++y)
@@ -527,4 +533,11 @@ void DoomRenderer::render(uint32_t* pixels, int screenW, int screenH,
     // Draw pickups
     if (pickupManager)
         pickupManager->renderPickups(pixels, screenW, screenH, player, zBuffer, map, colWallTop);
+
+    if (projectileManager)
+        projectileManager->render(pixels, screenW, screenH, player, zBuffer, colWallTop);
+
+    // Last, so smoke and glows blend over the sprites
+    if (particleSystem)
+        particleSystem->render(pixels, screenW, screenH, player, zBuffer, colWallTop);
 }
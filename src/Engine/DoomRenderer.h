@@ -9,15 +9,18 @@
 #include "BulletHoleManager.h"
 #include "SpriteRenderer.h"
 #include "PickupManager.h"
+#include "ProjectileManager.h"
+#include "ParticleSystem.h"
 #include "TextureManager.h"
 
 class TextureManager;
 
 class DoomRenderer {
 public:
-    // Provide segments and BSP root to the renderer (built by earlier steps)
-    DoomRenderer(const std::vector<GridSegment>& segments,
-                 std::unique_ptr<BSPNode> bspRoot);
+    // Flattened BSP from the baked level, nodeSegments holds the on-plane
+    // ranges the nodes point into
+    DoomRenderer(std::vector<FlatBSPNode> nodes,
+                 std::vector<GridSegment> nodeSegments);
 
     // Render into pixels buffer. zBuffer must be length screenW
     void render(uint32_t* pixels, int screenW, int screenH,
@@ -26,6 +29,8 @@ public:
     float colWallTop[1200]; // store the ceiling Y for each column
 
     void setPickupManager(PickupManager& manager) { pickupManager = &manager; }
+    void setProjectileManager(ProjectileManager& manager) { projectileManager = &manager; }
+    void setParticleSystem(ParticleSystem& system) { particleSystem = &system; }
 
     void drawBulletHolesOnWall(
             const GridSegment& seg, float sxA, float sxB, int screenW,
@@ -33,10 +38,12 @@ public:
             BulletHoleManager& bulletHoleManager, const Player& player, float playerToWallDist);
 
 private:
-    std::vector<GridSegment> m_segments;
-    std::unique_ptr<BSPNode> m_bspRoot;
+    std::vector<FlatBSPNode> m_nodes;
+    std::vector<GridSegment> m_nodeSegments;
 
     PickupManager* pickupManager = nullptr;
+    ProjectileManager* projectileManager = nullptr;
+    ParticleSystem* particleSystem = nullptr;
 
     static void renderWorldTileRasterized(uint32_t* pixels, float* zBuffer, int screenW, int screenH,
                                       const Player& player,
@@ -57,7 +64,7 @@ private:
                           const Player& player, const Map& map, float* zBuffer, const Texture& wallTex, BulletHoleManager& bulletHoleManager);
 
     // BSP traversal
-    void traverseBSP(const BSPNode* node, const Player& player,
+    void traverseBSP(int nodeIndex, const Player& player,
                      uint32_t* pixels, int screenW, int screenH,
                      const Map& map, float* zBuffer, uint8_t* tileDrawn, TextureManager& textureManager, BulletHoleManager& bulletHoleManager);
 
@@ -1,23 +1,39 @@
 #include "Enemy.h"
 #include "Player.h"
+#include "EnemyManager.h"
+#include <algorithm>
 #include <cmath>
 #include <cstdlib>
 
 Enemy::Enemy() {}
 
+float Enemy::randomFloat() {
+    // xorshift32, per enemy so results don't depend on update order
+    uint32_t v = rngState;
+    v ^= v << 13;
+    v ^= v >> 17;
+    v ^= v << 5;
+    rngState = v;
+
+    return float(v >> 8) * (1.0f / 16777216.0f); // 0.0–1.0
+}
+
 float Enemy::distanceTo(const Player& player) const {
-    float dx = player.x - x;
-    float dy = player.y - y;
+    float dx = player.x - hot->x[slot];
+    float dy = player.y - hot->y[slot];
     return std::sqrt(dx*dx + dy*dy);
 }
 
-void Enemy::activate(int tx, int ty, EnemyType t, EnemyManager& manager) {
-    x = float(tx) + 0.5f;
-    y = float(ty) + 0.5f;
+void Enemy::activate(int tx, int ty, EnemyType t, EnemyManager& manager, uint32_t seed) {
+    hot->x[slot] = float(tx) + 0.5f;
+    hot->y[slot] = float(ty) + 0.5f;
     type = t;
     active = true;
 
-    lateralOffset = ((rand() % 201) - 100) / 100.0f; // -1.0 to 1.0
+    // xorshift has a fixed point at zero
+    rngState = seed ? seed : 0x9E3779B9u;
+
+    lateralOffset = randomFloat() * 2.0f - 1.0f; // -1.0 to 1.0
 
     switch (type) {
         case EnemyType::Base: speed = 1.4f; break;
@@ -58,7 +74,7 @@ void Enemy::activate(int tx, int ty, EnemyType t, EnemyManager& manager) {
 
     // Health initialization
     maxHealth = getMaxHealthForType(type);
-    health = maxHealth;
+    hot->health[slot] = maxHealth;
 
     managerPtr = &manager;
 
@@ -66,11 +82,9 @@ void Enemy::activate(int tx, int ty, EnemyType t, EnemyManager& manager) {
     normalAnimation  = &manager.enemyVisuals.at(type).animations[animState];
     damagedAnimation = &manager.enemyVisualsDamaged.at(type).animations[animState];
 
-    // Set initial spritePixels to normal
-    spritePixels = normalAnimation->frames[0].pixels;
-    spriteW = normalAnimation->frames[0].w;
-    spriteH = normalAnimation->frames[0].h;
-    animFrame = 0;
+    // Start on the first normal frame
+    sprite = &normalAnimation->frames[0];
+    hot->animFrame[slot] = 0;
     animTimer = 0.0f;
 }
 
@@ -86,6 +100,9 @@ bool Enemy::hasLineOfSight(const Player& player, const Map& map) const {
     if (std::abs(heightDiff) > 0.5f)
         return false;
 
+    float x = hot->x[slot];
+    float y = hot->y[slot];
+
     float dx = player.x - x;
     float dy = player.y - y;
     float dist = std::sqrt(dx*dx + dy*dy);
@@ -94,114 +111,108 @@ bool Enemy::hasLineOfSight(const Player& player, const Map& map) const {
     if (dist > MAX_LOS_DISTANCE)
         return false;
 
-    float step = 0.1f;
-    int steps = int(dist / step);
-    if (steps <= 0)
-        return true;
-
-    float sx = x;
-    float sy = y;
-    float incX = dx / steps;
-    float incY = dy / steps;
-
     float blockingHeight = std::max(0.5f, std::abs(heightDiff) * 0.5f);
 
-    for (int i = 0; i < steps; i++) {
-        sx += incX;
-        sy += incY;
-
-        int mx = int(sx);
-        int my = int(sy);
-
-        const auto& tile = map.get(mx, my);
-
-        if (tile.type == Map::TileType::Wall) {
-            if (tile.height >= blockingHeight)
-                return false;
-        }
-    }
-
-    return true;
+    // Walls between the two tiles, precomputed per height class
+    return map.visibility.visible(int(x), int(y), int(player.x), int(player.y), blockingHeight);
 }
 
-void Enemy::playChaseSound(AudioManager& audio)
+void Enemy::playChaseSound(EnemyEventBuffer& events)
 {
+    float x = hot->x[slot];
+    float y = hot->y[slot];
+
     switch (type)
     {
         case EnemyType::Base:
-            audio.playSFX("zombie_idle_base");
+            events.playSound(SfxId::ZombieIdleBase, x, y);
             break;
 
         case EnemyType::Fast:
-            audio.playSFX("zombie_idle_fast");
+            events.playSound(SfxId::ZombieIdleFast, x, y);
             break;
 
         case EnemyType::Shooter:
-            audio.playSFX("zombie_idle_shooter");
+            events.playSound(SfxId::ZombieIdleShooter, x, y);
             break;
 
         case EnemyType::Tank:
-            audio.playSFX("zombie_idle_tank");
+            events.playSound(SfxId::ZombieIdleTank, x, y);
             break;
     }
 }
 
-void Enemy::chasePlayer(float dt, const Player& player, AudioManager& audio) {
+void Enemy::chasePlayer(float dt, const Player& player, EnemyEventBuffer& events) {
+    float& x = hot->x[slot];
+    float& y = hot->y[slot];
+
     float dx = player.x - x;
     float dy = player.y - y;
+
+    // Follow the shared flow field around walls, straight at the player once in their tile
+    float fx, fy;
+    if (managerPtr && managerPtr->flowField.direction(x, y, fx, fy)) {
+        dx = fx;
+        dy = fy;
+    }
+
     angle = std::atan2(dy, dx);
     x += std::cos(angle) * speed * dt;
     y += std::sin(angle) * speed * dt;
 
     if (ambientSoundTimer <= 0.0f)
     {
-        playChaseSound(audio);
+        playChaseSound(events);
         // 10–20 seconds until next sound
-        ambientSoundTimer = 10.0f + ((float)rand() / RAND_MAX) * 10.0f;
+        ambientSoundTimer = 10.0f + randomFloat() * 10.0f;
     }
 }
 
-void Enemy::playWanderSound(AudioManager& audio)
+void Enemy::playWanderSound(EnemyEventBuffer& events)
 {
+    float x = hot->x[slot];
+    float y = hot->y[slot];
+
     switch (type)
     {
         case EnemyType::Base:
-            audio.playSFX("zombie_chase_base");
+            events.playSound(SfxId::ZombieChaseBase, x, y);
             break;
 
         case EnemyType::Fast:
-            audio.playSFX("zombie_chase_fast");
+            events.playSound(SfxId::ZombieChaseFast, x, y);
             break;
 
         case EnemyType::Shooter:
-            audio.playSFX("zombie_chase_shooter");
+            events.playSound(SfxId::ZombieChaseShooter, x, y);
             break;
 
         case EnemyType::Tank:
-            audio.playSFX("zombie_chase_tank");
+            events.playSound(SfxId::ZombieChaseTank, x, y);
             break;
     }
 }
 
-void Enemy::wander(float dt, AudioManager& audio) {
+void Enemy::wander(float dt, EnemyEventBuffer& events) {
     wanderTimer -= dt;
 
     if (wanderTimer <= 0.0f) {
-        wanderAngle = ((rand() % 628) / 100.0f) - 3.14f;
-        wanderTimer = 2.0f + (rand() % 200) / 100.0f;
+        wanderAngle = randomFloat() * 6.28f - 3.14f;
+        wanderTimer = 2.0f + randomFloat() * 2.0f;
     }
 
-    x += std::cos(wanderAngle) * speed * 0.3f * dt;
-    y += std::sin(wanderAngle) * speed * 0.3f * dt;
+    hot->x[slot] += std::cos(wanderAngle) * speed * 0.3f * dt;
+    hot->y[slot] += std::sin(wanderAngle) * speed * 0.3f * dt;
 
     if (ambientSoundTimer <= 0.0f) {
-        playWanderSound(audio);
+        playWanderSound(events);
         // 16–26 seconds until next sound
-        ambientSoundTimer = 16.0f + ((float)rand() / RAND_MAX) * 10.0f;
+        ambientSoundTimer = 16.0f + randomFloat() * 10.0f;
     }
 }
 
 void Enemy::updateAnimation(float dt) {
+    int& animFrame = hot->animFrame[slot];
     animTimer += dt;
 
     float frameTime = 0.15f;
@@ -218,8 +229,8 @@ void Enemy::updateAnimation(float dt) {
             : &managerPtr->enemyVisuals.at(type).animations.at(animState);
 
         if (animState == EnemyAnimState::Death) {
-            if (animFrame >= currentAnim->frames.size()) {
-                animFrame = currentAnim->frames.size() - 1;
+            if (animFrame >= (int)currentAnim->frames.size()) {
+                animFrame = (int)currentAnim->frames.size() - 1;
 
                 // Only set flags once (for spawning ammo)
                 if (!deathAnimFinished) {
@@ -229,28 +240,42 @@ void Enemy::updateAnimation(float dt) {
             }
         }
         else {
-            if (animFrame >= currentAnim->frames.size())
+            if (animFrame >= (int)currentAnim->frames.size())
                 animFrame = 0;
         }
 
-        spritePixels = currentAnim->frames[animFrame].pixels;
-        spriteW = currentAnim->frames[animFrame].w;
-        spriteH = currentAnim->frames[animFrame].h;
+        sprite = &currentAnim->frames[animFrame];
     }
 }
 
+void Enemy::syncSprite() {
+    const auto& visuals = isDamaged() ? managerPtr->enemyVisualsDamaged : managerPtr->enemyVisuals;
+
+    auto vis = visuals.find(type);
+    if (vis == visuals.end()) return;
+
+    auto anim = vis->second.animations.find(animState);
+    if (anim == vis->second.animations.end() || anim->second.frames.empty()) return;
+
+    const auto& frames = anim->second.frames;
+    const SpriteFrame& frame = frames[std::min(hot->animFrame[slot], (int)frames.size() - 1)];
+
+    sprite = &frame;
+}
+
 void Enemy::takeDamage(int amount) {
+    int& health = hot->health[slot];
     health -= amount;
     if (health < 0)
         health = 0;
 }
 
 bool Enemy::isDamaged() const {
-    return health <= maxHealth / 2;
+    return hot->health[slot] <= maxHealth / 2;
 }
 
 bool Enemy::isDead() const {
-    return health <= 0;
+    return hot->health[slot] <= 0;
 }
 
 int Enemy::getMaxHealthForType(EnemyType t) const {
@@ -291,32 +316,35 @@ bool Enemy::canAttack(const Player& player) const {
     return distanceTo(player) <= attackRange;
 }
 
-void Enemy::handleAttack(float dt, Player& player, AudioManager& audio) {
+void Enemy::handleAttack(float dt, const Player& player, EnemyEventBuffer& events) {
+    float x = hot->x[slot];
+    float y = hot->y[slot];
+    int& animFrame = hot->animFrame[slot];
+
     animState = EnemyAnimState::Attack;
 
     // Apply damage on the hit frame
     if (!hasDealtDamageThisAttack && animFrame == attackHitFrame) {
 
-        bool hit = true;
-
         switch (type) {
-            case EnemyType::Tank: audio.playSFX("tank_attack"); break;
-            case EnemyType::Shooter: audio.playSFX("shooter_attack"); break;
-            case EnemyType::Fast: audio.playSFX("fast_attack"); break;
-            case EnemyType::Base: audio.playSFX("base_attack"); break;
-            default: audio.playSFX("base_attack"); break;
+            case EnemyType::Tank: events.playSound(SfxId::TankAttack, x, y, 1.5f); break;
+            case EnemyType::Shooter: events.playSound(SfxId::ShooterAttack, x, y, 1.5f); break;
+            case EnemyType::Fast: events.playSound(SfxId::FastAttack, x, y, 1.5f); break;
+            case EnemyType::Base: events.playSound(SfxId::BaseAttack, x, y, 1.5f); break;
+            default: events.playSound(SfxId::BaseAttack, x, y, 1.5f); break;
         }
 
-        // Determine if shooter zombie hits or misses
         if (type == EnemyType::Shooter) {
-            float roll = float(rand()) / float(RAND_MAX); // 0.0–1.0
-            hit = (roll <= getHitChance(player));
-        }
+            // Real shot at the player, less accurate the further away
+            float spread = (1.0f - getHitChance(player)) * SHOT_SPREAD;
+            float aim = std::atan2(player.y - y, player.x - x) + (randomFloat() * 2.0f - 1.0f) * spread;
 
-        if (hit) {
-            player.applyDamage(attackDamage, getShieldMultiplier());
+            events.fireProjectile(x, y, hot->z[slot] + SHOT_HEIGHT, std::cos(aim), std::sin(aim),
+                                  attackDamage, getShieldMultiplier());
+        }
+        else {
+            events.damagePlayer(attackDamage, getShieldMultiplier());
         }
-        // else miss — do nothing (will add sound later)
 
         hasDealtDamageThisAttack = true;
     }
@@ -326,20 +354,25 @@ void Enemy::handleAttack(float dt, Player& player, AudioManager& audio) {
         ? &managerPtr->enemyVisualsDamaged.at(type).animations.at(animState)
         : &managerPtr->enemyVisuals.at(type).animations.at(animState);
 
-    if (animFrame == currentAnim->frames.size() - 1) {
+    if (animFrame == (int)currentAnim->frames.size() - 1) {
         attackTimer = attackCooldown;
 
         hasDealtDamageThisAttack = false;
         animFrame = 0;
         animTimer = 0.0f;
 
-        state = EnemyState::Chasing;
+        hot->state[slot] = EnemyState::Chasing;
     }
 }
 
-void Enemy::update(float dt, const Player& player, const Map& map, AudioManager& audio, EnemyType t) {
+void Enemy::update(float dt, const Player& player, const Map& map, EnemyEventBuffer& events, EnemyType t) {
     if (!active) return;
 
+    float x = hot->x[slot];
+    float y = hot->y[slot];
+    EnemyState& state = hot->state[slot];
+    int& animFrame = hot->animFrame[slot];
+
     if (isDead()) {
         if (animState != EnemyAnimState::Death) {
             animState = EnemyAnimState::Death;
@@ -349,19 +382,19 @@ void Enemy::update(float dt, const Player& player, const Map& map, AudioManager&
             switch (t)
             {
                 case EnemyType::Base:
-                    audio.playSFX("zombie_dead_base");
+                    events.playSound(SfxId::ZombieDeadBase, x, y, 2.0f);
                     break;
 
                 case EnemyType::Fast:
-                    audio.playSFX("zombie_dead_fast");
+                    events.playSound(SfxId::ZombieDeadFast, x, y, 2.0f);
                     break;
 
                 case EnemyType::Shooter:
-                    audio.playSFX("zombie_dead_shooter");
+                    events.playSound(SfxId::ZombieDeadShooter, x, y, 2.0f);
                     break;
 
                 case EnemyType::Tank:
-                    audio.playSFX("zombie_dead_tank");
+                    events.playSound(SfxId::ZombieDeadTank, x, y, 2.0f);
                     break;
             }
         }
@@ -382,7 +415,7 @@ void Enemy::update(float dt, const Player& player, const Map& map, AudioManager&
         case EnemyState::Idle:
             animState = EnemyAnimState::Idle;
             if (seesPlayer) state = EnemyState::Chasing;
-            else wander(dt, audio);
+            else wander(dt, events);
             break;
 
         case EnemyState::Chasing:
@@ -400,7 +433,7 @@ void Enemy::update(float dt, const Player& player, const Map& map, AudioManager&
                     break;
                 }
 
-                chasePlayer(dt, player, audio);
+                chasePlayer(dt, player, events);
                 loseSightTimer = 1.0f;
             } else {
                 state = EnemyState::Searching;
@@ -410,12 +443,12 @@ void Enemy::update(float dt, const Player& player, const Map& map, AudioManager&
         case EnemyState::Searching:
             animState = EnemyAnimState::Walk;
             loseSightTimer -= dt;
-            chasePlayer(dt, player, audio);
+            chasePlayer(dt, player, events);
             if (loseSightTimer <= 0.0f) state = EnemyState::Idle;
             break;
 
         case EnemyState::Attacking:
-            handleAttack(dt, const_cast<Player&>(player), audio);
+            handleAttack(dt, player, events);
             break;
     }
 
@@ -423,14 +456,14 @@ void Enemy::update(float dt, const Player& player, const Map& map, AudioManager&
 }
 
 void Enemy::reset() {
-    health = maxHealth;
+    hot->health[slot] = maxHealth;
 
     active = false;
 
-    state = EnemyState::Idle;
+    hot->state[slot] = EnemyState::Idle;
     animState = EnemyAnimState::Idle;
 
-    animFrame = 0;
+    hot->animFrame[slot] = 0;
     animTimer = 0.0f;
 
     deathAnimFinished = false;
@@ -439,8 +472,6 @@ void Enemy::reset() {
     loseSightTimer = 0.0f;
     hasDealtDamageThisAttack = false;
 
-    spritePixels.clear();
-    spriteW = 0;
-    spriteH = 0;
+    sprite = nullptr;
 }
 
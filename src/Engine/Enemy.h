@@ -2,13 +2,15 @@
 #define ENEMY_H
 
 #include <vector>
+#include <cstdint>
 #include <SDL2/SDL.h>
 #include "Map.h"
-#include "../audio/AudioManager.h"
+#include "EnemyEvents.h"
 
 class Player;
 class EnemyManager;
 struct Animation;
+struct SpriteFrame;
 
 enum class EnemyType {
     Base,
@@ -31,24 +33,36 @@ enum class EnemyAnimState {
     Death
 };
 
+// The per-enemy state every whole-population loop touches (simulation,
+// separation, render, hitscan), as parallel arrays indexed by slot. This is
+// the only copy; Enemy reaches its own entries through hot / slot.
+struct EnemyHot {
+    std::vector<float> x;
+    std::vector<float> y;
+    std::vector<float> z;
+    std::vector<float> height;
+    std::vector<int> health;
+    std::vector<EnemyState> state;
+    std::vector<int> animFrame;
+
+    void resize(int n);
+};
+
 class Enemy {
 public:
-    // Core
-    float x = 0.0f;
-    float y = 0.0f;
-    float z = 0.0f;
-    float height = 0;
+    // Where this enemy's hot state lives, bound once by the manager
+    EnemyHot* hot = nullptr;
+    int slot = -1;
 
+    // Core
     float speed = 0.0f;
     float angle = 0.0f;
     bool active = false;
 
     EnemyType type = EnemyType::Base;
-    EnemyState state = EnemyState::Idle;
     EnemyAnimState animState = EnemyAnimState::Idle;
 
-    // Health
-    int health = 0;
+    // Health, the current value is hot->health
     int maxHealth = 0;
 
     // Combat
@@ -60,8 +74,11 @@ public:
     bool attacking = false;
     bool hasDealtDamageThisAttack = false;
 
-    // Animation
-    int animFrame = 0;
+    // Shooter projectiles: launch height above the feet, widest aim error (radians)
+    static constexpr float SHOT_HEIGHT = 0.5f;
+    static constexpr float SHOT_SPREAD = 0.25f;
+
+    // Animation, the current frame is hot->animFrame
     float animTimer = 0.0f;
     bool deathAnimFinished = false;
     bool deathJustFinished = false;
@@ -69,9 +86,8 @@ public:
     Animation* normalAnimation  = nullptr;
     Animation* damagedAnimation = nullptr;
 
-    int spriteW = 0;
-    int spriteH = 0;
-    std::vector<uint32_t> spritePixels;
+    // Current frame, points into the manager's shared animations
+    const SpriteFrame* sprite = nullptr;
 
     // Enemy AI
     float ambientSoundTimer = 2.0f + ((float)rand() / RAND_MAX) * 10.0f;
@@ -80,12 +96,16 @@ public:
     float wanderTimer = 0.0f;
     float lateralOffset = 0.0f;
 
+    // Private random stream, seeded on spawn and saved with checkpoints
+    uint32_t rngState = 1;
+
     EnemyManager* managerPtr = nullptr;
 
     Enemy();
 
-    void activate(int tx, int ty, EnemyType t, EnemyManager& manager);
-    void update(float dt, const Player& player, const Map& map, AudioManager& audio, EnemyType t);
+    void activate(int tx, int ty, EnemyType t, EnemyManager& manager, uint32_t seed);
+    // Touches only this enemy; anything aimed at the player or audio goes to events
+    void update(float dt, const Player& player, const Map& map, EnemyEventBuffer& events, EnemyType t);
     void reset();
     void deactivate() { active = false; }
 
@@ -94,22 +114,26 @@ public:
     bool isDamaged() const;
 
     bool hasLineOfSight(const Player& player, const Map& map) const;
-    void chasePlayer(float dt, const Player& player, AudioManager& audio);
-    void wander(float dt, AudioManager& audio);
+    void chasePlayer(float dt, const Player& player, EnemyEventBuffer& events);
+    void wander(float dt, EnemyEventBuffer& events);
 
     bool canAttack(const Player& player) const;
-    void handleAttack(float dt, Player& player, AudioManager& audio);
+    void handleAttack(float dt, const Player& player, EnemyEventBuffer& events);
 
     void updateAnimation(float dt);
+
+    // Point sprite at the current animation frame
+    void syncSprite();
     float distanceTo(const Player& player) const;
 
 private:
     int getMaxHealthForType(EnemyType t) const;
     float getHitChance(const Player& player) const;
     float getShieldMultiplier() const;
+    float randomFloat();
 
-    void playWanderSound(AudioManager& audio);
-    void playChaseSound(AudioManager& audio);
+    void playWanderSound(EnemyEventBuffer& events);
+    void playChaseSound(EnemyEventBuffer& events);
 };
 
 #endif
@@ -0,0 +1,67 @@
+#pragma once
+#include <vector>
+#include "../audio/SfxId.h"
+
+// Side effects an enemy wants applied to the rest of the game. Enemies may
+// update on worker threads, so they only append here; EnemyManager applies
+// the buffers afterwards on the main thread, in active-list order.
+struct EnemyEvent {
+    enum class Type {
+        Sound,
+        DamagePlayer,
+        FireProjectile
+    };
+
+    Type type;
+
+    // Sound, FireProjectile
+    SfxId sfx;
+    float x, y;
+    float priority;
+
+    // DamagePlayer, FireProjectile
+    int damage;
+    float shieldMultiplier;
+
+    // FireProjectile
+    float z;
+    float dirX, dirY;
+};
+
+struct EnemyEventBuffer {
+    std::vector<EnemyEvent> events;
+
+    void clear() { events.clear(); }
+
+    void playSound(SfxId id, float x, float y, float priority = 1.0f) {
+        EnemyEvent e{};
+        e.type = EnemyEvent::Type::Sound;
+        e.sfx = id;
+        e.x = x;
+        e.y = y;
+        e.priority = priority;
+        events.push_back(e);
+    }
+
+    void damagePlayer(int damage, float shieldMultiplier) {
+        EnemyEvent e{};
+        e.type = EnemyEvent::Type::DamagePlayer;
+        e.damage = damage;
+        e.shieldMultiplier = shieldMultiplier;
+        events.push_back(e);
+    }
+
+    void fireProjectile(float x, float y, float z, float dirX, float dirY,
+                        int damage, float shieldMultiplier) {
+        EnemyEvent e{};
+        e.type = EnemyEvent::Type::FireProjectile;
+        e.x = x;
+        e.y = y;
+        e.z = z;
+        e.dirX = dirX;
+        e.dirY = dirY;
+        e.damage = damage;
+        e.shieldMultiplier = shieldMultiplier;
+        events.push_back(e);
+    }
+};
@@ -1,5 +1,7 @@
 #include "EnemyManager.h"
 #include "Player.h"
+#include "GameSnapshot.h"
+#include <algorithm>
 #include <random>
 #include <cmath>
 #include <cstring>
@@ -8,20 +10,104 @@
 #include "../third_party/stb_image_wrapper.h"
 #include "../Utils/PathUtils.h"
 
-EnemyManager::EnemyManager() {
-    for (int i = 0; i < MAX_ENEMIES; i++)
-        enemies[i].active = false;
+void EnemyHot::resize(int n) {
+    x.assign(n, 0.0f);
+    y.assign(n, 0.0f);
+    z.assign(n, 0.0f);
+    height.assign(n, 0.0f);
+    health.assign(n, 0);
+    state.assign(n, EnemyState::Idle);
+    animFrame.assign(n, 0);
 }
 
-void EnemyManager::scanMapForSpawnPoints(const Map& map) {
-    spawnPoints.clear();
-    for (int x = 0; x < map.SIZE; x++) {
-        for (int y = 0; y < map.SIZE; y++) {
-            if (map.get(x,y).type == Map::TileType::Spawn) {
-                spawnPoints.push_back({ x, y });
-            }
-        }
+EnemyManager::EnemyManager(int capacity, int threads)
+    : workers(threads)
+{
+    capacity = std::max(1, capacity);
+
+    enemies.resize(capacity);
+    hot.resize(capacity);
+
+    // Each record is tied to its slot in the hot arrays for good
+    for (int i = 0; i < capacity; i++) {
+        enemies[i].hot = &hot;
+        enemies[i].slot = i;
     }
+
+    pendingDt.assign(capacity, 0.0f);
+    wakeTimer.assign(capacity, 0.0f);
+    dueList.reserve(capacity);
+
+    query.stamp.assign(capacity, 0);
+    query.slots.reserve(capacity);
+
+    activeList.reserve(capacity);
+    activePos.assign(capacity, -1);
+
+    // Lowest slot on top, so spawns fill from the start like before
+    freeList.reserve(capacity);
+    for (int i = capacity - 1; i >= 0; i--)
+        freeList.push_back(i);
+
+    grid.init(Map::FALLBACK_SIZE, Map::FALLBACK_SIZE, capacity);
+}
+
+int EnemyManager::allocateSlot() {
+    if (freeList.empty())
+        return -1;
+
+    int slot = freeList.back();
+    freeList.pop_back();
+
+    activePos[slot] = (int)activeList.size();
+    activeList.push_back(slot);
+
+    pendingDt[slot] = 0.0f;
+    wakeTimer[slot] = 0.0f;
+    return slot;
+}
+
+void EnemyManager::releaseSlot(int slot) {
+    int pos = activePos[slot];
+    if (pos < 0)
+        return;
+
+    // Swap-remove from the dense list
+    int last = activeList.back();
+    activeList[pos] = last;
+    activePos[last] = pos;
+    activeList.pop_back();
+
+    activePos[slot] = -1;
+    freeList.push_back(slot);
+
+    grid.remove(slot);
+}
+
+void EnemyManager::retireCorpse(int slot) {
+    Enemy& e = enemies[slot];
+    if (e.sprite)
+        corpses.add(hot.x[slot], hot.y[slot], hot.z[slot], hot.height[slot], e.sprite);
+
+    releaseSlot(slot);
+    e.reset();
+}
+
+uint32_t EnemyManager::nextSeed() {
+    // splitmix32 over the spawn count, so a run replays the same streams
+    uint32_t z = ++spawnCounter * 0x9E3779B9u;
+    z = (z ^ (z >> 16)) * 0x85EBCA6Bu;
+    z = (z ^ (z >> 13)) * 0xC2B2AE35u;
+    return z ^ (z >> 16);
+}
+
+void EnemyManager::setSpawnPoints(const Map& map, const std::vector<std::pair<int,int>>& points) {
+    // Sized to the level, the pool must be empty here
+    grid.init(map.width, map.height, capacity());
+
+    spawnPoints.clear();
+    for (const auto& [x, y] : points)
+        spawnPoints.push_back({ x, y });
 }
 
 bool loadSpriteFrame(const std::string& path, SpriteFrame& out) {
@@ -356,22 +442,31 @@ Enemy* EnemyManager::spawnEnemy(EnemyType type) {
     const auto& pt = spawnPoints[nextSpawnIndex];
     nextSpawnIndex = (nextSpawnIndex + 1) % spawnPoints.size();
 
-    for (int i = 0; i < MAX_ENEMIES; i++) {
-        if (!enemies[i].active) {
-            Enemy& e = enemies[i];
-            e.reset();
-            e.activate(pt.x, pt.y, type, *this);
-            e.z = 0.0f;
-            e.height = 0.75f;
-            return &e;
-        }
-    }
+    int slot = allocateSlot();
+    if (slot < 0) return nullptr;
+
+    Enemy& e = enemies[slot];
+    e.reset();
+    e.activate(pt.x, pt.y, type, *this, nextSeed());
+    hot.z[slot] = 0.0f;
+    hot.height[slot] = 0.75f;
+
+    grid.insert(slot, hot.x[slot], hot.y[slot]);
+    return &e;
+}
+
+void EnemyManager::damageEnemy(int slot, int amount) {
+    if (slot < 0 || slot >= capacity() || activePos[slot] < 0)
+        return;
+
+    enemies[slot].takeDamage(amount);
 
-    return nullptr;
+    // Getting shot wakes an enemy wherever it is
+    wakeTimer[slot] = WAKE_TIME;
 }
 
 void EnemyManager::trySpawnAmmoDrop(
-    const Enemy& e,
+    int slot,
     const Player& player,
     PickupManager& pickupManager)
 {
@@ -403,73 +498,199 @@ void EnemyManager::trySpawnAmmoDrop(
     }
 
     pickupManager.addPickup(
-        e.x,
-        e.y,
+        hot.x[slot],
+        hot.y[slot],
         0.0f,
         PickupType::Ammo,
         weaponType
     );
 }
 
-void EnemyManager::update(float dt, const Player& player, PickupManager& pickupManager, const Map& map, AudioManager& audio) {
-    for (int i = 0; i < MAX_ENEMIES; i++) {
-        Enemy& e = enemies[i];
-        if (!e.active) continue;
+EnemyManager::SimTier EnemyManager::classify(int slot, int playerChunk, int ptx, int pty, const Map& map) const {
+    if (wakeTimer[slot] > 0.0f)
+        return SimTier::Full;
+
+    int tx = int(hot.x[slot]);
+    int ty = int(hot.y[slot]);
+
+    int chunkDist = map.chunkDistance(playerChunk, map.getChunkID(tx, ty));
+    if (chunkDist == 0)
+        return SimTier::Full;
+
+    // Anything the player could be looking at stays smooth
+    if (map.visibility.visible(ptx, pty, tx, ty, 0.5f))
+        return SimTier::Full;
 
-        // Save previous position
-        float oldX = e.x;
-        float oldY = e.y;
+    if (chunkDist == 1)
+        return SimTier::Reduced;
 
-        e.update(dt, player, map, audio, e.type);
+    // Far away: only enemies already doing something keep going
+    if (hot.state[slot] == EnemyState::Idle && hot.health[slot] > 0)
+        return SimTier::Asleep;
+
+    return SimTier::Reduced;
+}
+
+void EnemyManager::update(float dt, Player& player, PickupManager& pickupManager, const Map& map, AudioManager& audio,
+                          ProjectileManager& projectiles) {
+    // Cheap no-op unless the player changed tile or a wall opened / closed
+    flowField.update(map, int(player.x), int(player.y));
+
+    frameIndex++;
+
+    int ptx = int(player.x);
+    int pty = int(player.y);
+    int playerChunk = map.getChunkID(ptx, pty);
+
+    dueList.clear();
+    for (int i : activeList) {
+        wakeTimer[i] = std::max(0.0f, wakeTimer[i] - dt);
+
+        switch (classify(i, playerChunk, ptx, pty, map)) {
+            case SimTier::Full:
+                pendingDt[i] += dt;
+                dueList.push_back(i);
+                break;
+
+            case SimTier::Reduced:
+                pendingDt[i] += dt;
+                if ((frameIndex + (uint32_t)i) % REDUCED_INTERVAL == 0)
+                    dueList.push_back(i);
+                break;
+
+            case SimTier::Asleep:
+                // Sleeping time is not owed, the enemy picks up where it was
+                pendingDt[i] = 0.0f;
+                break;
+        }
+    }
+
+    int count = (int)dueList.size();
+    if (count > 0) {
+        // Contiguous runs of the due list, each with its own event buffer.
+        // Only slot's record and hot entries are written here, everything shared is read-only.
+        int jobs = std::min(workers.concurrency(),
+                            (count + MIN_ENEMIES_PER_JOB - 1) / MIN_ENEMIES_PER_JOB);
+        int perJob = (count + jobs - 1) / jobs;
+
+        if ((int)jobEvents.size() < jobs) {
+            jobEvents.resize(jobs);
+            jobMoves.resize(jobs);
+        }
+
+        workers.run(jobs, [&](int job) {
+            EnemyEventBuffer& events = jobEvents[job];
+            CollisionBatch& moves = jobMoves[job];
+            events.clear();
+            moves.clear();
+
+            int begin = job * perJob;
+            int end = std::min(count, begin + perJob);
+            for (int k = begin; k < end; k++) {
+                int slot = dueList[k];
+                simulateEnemy(slot, pendingDt[slot], player, map, events, moves);
+                pendingDt[slot] = 0.0f;
+            }
+
+            // Every move this job made against the walls in one pass
+            Collision::moveBatch(map, moves, ENEMY_RADIUS, Map::STEP_HEIGHT);
+            for (int k = begin; k < end; k++)
+                finishMove(dueList[k], moves, k - begin, map);
+        });
+
+        // Buffers in job order are the due list in order, however it was split
+        for (int job = 0; job < jobs; job++)
+            applyEvents(jobEvents[job], player, audio, projectiles);
+    }
+
+    for (int i : dueList) {
+        Enemy& e = enemies[i];
 
         // Death logic
         if (e.deathJustFinished) {
-            trySpawnAmmoDrop(e, player, pickupManager);
+            trySpawnAmmoDrop(i, player, pickupManager);
             // Keep track of enemies killed
             enemiesKilled += 1;
             e.deathJustFinished = false;
         }
 
-        // Wall Collision with height check
-        int px = int(e.x);
-        int py = int(e.y);
+        // Nothing left to simulate, free the slot for the next spawn
+        if (e.deathAnimFinished) {
+            retireCorpse(i);
+            continue;
+        }
 
-        const auto& tile = map.get(px, py);
+        grid.move(i, hot.x[i], hot.y[i]);
+    }
 
-        if (tile.type == Map::TileType::Wall) {
-            float wallHeight = tile.height;
-            float stepHeight = 0.25f; // enemy step capability
+    separateEnemies(map);
+}
 
-            if (wallHeight > stepHeight) {
-                // Solid wall, block movement
-                e.x = oldX;
-                e.y = oldY;
+void EnemyManager::simulateEnemy(int slot, float dt, const Player& player, const Map& map,
+                                 EnemyEventBuffer& events, CollisionBatch& moves) {
+    Enemy& e = enemies[slot];
 
-                // Re-roll wander direction if idle
-                if (e.state == EnemyState::Idle) {
-                    e.wanderTimer = 0.0f;
-                }
-            }
-            else {
-                // Walkable wall, step onto it
-                e.z = wallHeight;
-            }
-        }
-        else {
-            // Not a wall, return to ground
-            e.z = 0.0f;
+    float startX = hot.x[slot];
+    float startY = hot.y[slot];
+
+    e.update(dt, player, map, events, e.type);
+
+    // Resolved against the walls with the rest of the job, see finishMove()
+    moves.add(startX, startY, hot.x[slot] - startX, hot.y[slot] - startY, 0.0f);
+}
+
+void EnemyManager::finishMove(int slot, const CollisionBatch& moves, int index, const Map& map) {
+    float x = hot.x[slot] = moves.x[index];
+    float y = hot.y[slot] = moves.y[index];
+
+    // Re-roll wander direction if idle
+    if (moves.blocked[index] && hot.state[slot] == EnemyState::Idle)
+        enemies[slot].wanderTimer = 0.0f;
+
+    // Stand on steps and in pits, floor tiles are height 0
+    float floorHeight = map.heightFast(int(x), int(y));
+    if (floorHeight <= Map::STEP_HEIGHT)
+        hot.z[slot] = floorHeight;
+}
+
+void EnemyManager::applyEvents(const EnemyEventBuffer& events, Player& player, AudioManager& audio,
+                               ProjectileManager& projectiles) {
+    for (const EnemyEvent& ev : events.events) {
+        switch (ev.type) {
+            case EnemyEvent::Type::Sound:
+                audio.playSFXAt(ev.sfx, ev.x, ev.y, 1.0f, ev.priority);
+                break;
+
+            case EnemyEvent::Type::DamagePlayer:
+                player.applyDamage(ev.damage, ev.shieldMultiplier);
+                break;
+
+            case EnemyEvent::Type::FireProjectile:
+                projectiles.spawn(ev.x, ev.y, ev.z, ev.dirX, ev.dirY, ev.damage, ev.shieldMultiplier);
+                break;
         }
+    }
+}
+
+void EnemyManager::separateEnemies(const Map& map) {
+    const float minDist = 0.8f;
+
+    float* xs = hot.x.data();
+    float* ys = hot.y.data();
 
-        // Enemy separation
-        for (int j = 0; j < MAX_ENEMIES; j++) {
-            if (i == j) continue;
-            Enemy& other = enemies[j];
-            if (!other.active) continue;
+    // Starting points, the pushes below are resolved against walls from here
+    separationMoves.clear();
+    for (int i : activeList)
+        separationMoves.add(xs[i], ys[i], 0.0f, 0.0f, 0.0f);
 
-            float dx = e.x - other.x;
-            float dy = e.y - other.y;
+    for (int i : activeList) {
+        // Each close pair is handled once, from its lower index
+        grid.forEachNear(xs[i], ys[i], minDist, [&](int j) {
+            if (j <= i) return;
+
+            float dx = xs[i] - xs[j];
+            float dy = ys[i] - ys[j];
             float distSq = dx*dx + dy*dy;
-            float minDist = 0.8f;
 
             if (distSq < minDist * minDist) {
                 float dist = std::sqrt(distSq);
@@ -478,40 +699,171 @@ void EnemyManager::update(float dt, const Player& player, PickupManager& pickupM
                     dx /= dist;
                     dy /= dist;
 
-                    e.x += dx * push;
-                    e.y += dy * push;
-                    other.x -= dx * push;
-                    other.y -= dy * push;
+                    xs[i] += dx * push;
+                    ys[i] += dy * push;
+                    xs[j] -= dx * push;
+                    ys[j] -= dy * push;
                 }
             }
-        }
+        });
+    }
+
+    // Pushes slide along walls like any other move instead of into them
+    int k = 0;
+    for (int i : activeList) {
+        separationMoves.dx[k] = xs[i] - separationMoves.x[k];
+        separationMoves.dy[k] = ys[i] - separationMoves.y[k];
+        k++;
+    }
+
+    Collision::moveBatch(map, separationMoves, ENEMY_RADIUS, Map::STEP_HEIGHT);
+
+    k = 0;
+    for (int i : activeList) {
+        xs[i] = separationMoves.x[k];
+        ys[i] = separationMoves.y[k];
+        k++;
+
         // Failsafe
-        e.x = std::clamp(e.x, 1.0f, map.SIZE - 2.0f);
-        e.y = std::clamp(e.y, 1.0f, map.SIZE - 2.0f);
+        xs[i] = std::clamp(xs[i], 1.0f, map.width - 2.0f);
+        ys[i] = std::clamp(ys[i], 1.0f, map.height - 2.0f);
+
+        grid.move(i, xs[i], ys[i]);
     }
 }
 
 bool EnemyManager::hasActiveEnemies() const
 {
-    for (int i = 0; i < MAX_ENEMIES; i++)
-        if (enemies[i].active &&
-            !enemies[i].deathAnimFinished)
-            return true;
-
-    return false;
+    return !activeList.empty();
 }
 
 int EnemyManager::getActiveEnemyCount() const {
-    int count = 0;
-    for (int i = 0; i < MAX_ENEMIES; i++)
-        if (enemies[i].active && enemies[i].deathAnimFinished == false) count++;
-    return count;
+    return (int)activeList.size();
+}
+
+void EnemyManager::reset() {
+    deactivateAll();
+    nextSpawnIndex = 0;
+    spawnCounter = 0;
+    enemiesKilled = 0;
 }
 
 void EnemyManager::deactivateAll() {
-    for (int i = 0; i < MAX_ENEMIES; i++) {
-        enemies[i].active = false;
-        enemies[i].reset();
+    while (!activeList.empty()) {
+        int slot = activeList.back();
+        releaseSlot(slot);
+        enemies[slot].reset();
+    }
+
+    corpses.clear();
+}
+
+
+void EnemyManager::saveSnapshot(GameSnapshot& out) const {
+    out.enemyCount = 0;
+
+    for (int i : activeList) {
+        if (out.enemyCount == GameSnapshot::MAX_ENEMIES) break;
+
+        const Enemy& e = enemies[i];
+        EnemySnapshot& s = out.enemies[out.enemyCount++];
+
+        s.x = hot.x[i];
+        s.y = hot.y[i];
+        s.z = hot.z[i];
+        s.height = hot.height[i];
+        s.speed = e.speed;
+        s.angle = e.angle;
+
+        s.type = e.type;
+        s.state = hot.state[i];
+        s.animState = e.animState;
+
+        s.health = hot.health[i];
+        s.maxHealth = e.maxHealth;
+
+        s.attackRange = e.attackRange;
+        s.attackDamage = e.attackDamage;
+        s.attackCooldown = e.attackCooldown;
+        s.attackTimer = e.attackTimer;
+        s.attackHitFrame = e.attackHitFrame;
+        s.attacking = e.attacking;
+        s.hasDealtDamageThisAttack = e.hasDealtDamageThisAttack;
+
+        s.animFrame = hot.animFrame[i];
+        s.animTimer = e.animTimer;
+        s.deathAnimFinished = e.deathAnimFinished;
+        s.deathJustFinished = e.deathJustFinished;
+
+        s.ambientSoundTimer = e.ambientSoundTimer;
+        s.loseSightTimer = e.loseSightTimer;
+        s.wanderAngle = e.wanderAngle;
+        s.wanderTimer = e.wanderTimer;
+        s.lateralOffset = e.lateralOffset;
+        s.rngState = e.rngState;
     }
+
+    out.nextSpawnIndex = nextSpawnIndex;
+    out.spawnCounter = spawnCounter;
+    out.enemiesKilled = enemiesKilled;
 }
 
+void EnemyManager::restoreSnapshot(const GameSnapshot& in) {
+    deactivateAll();
+
+    for (int i = 0; i < in.enemyCount; i++) {
+        int slot = allocateSlot();
+        if (slot < 0) break;
+
+        Enemy& e = enemies[slot];
+        const EnemySnapshot& s = in.enemies[i];
+
+        hot.x[slot] = s.x;
+        hot.y[slot] = s.y;
+        hot.z[slot] = s.z;
+        hot.height[slot] = s.height;
+        e.speed = s.speed;
+        e.angle = s.angle;
+        e.active = true;
+
+        e.type = s.type;
+        hot.state[slot] = s.state;
+        e.animState = s.animState;
+
+        hot.health[slot] = s.health;
+        e.maxHealth = s.maxHealth;
+
+        e.attackRange = s.attackRange;
+        e.attackDamage = s.attackDamage;
+        e.attackCooldown = s.attackCooldown;
+        e.attackTimer = s.attackTimer;
+        e.attackHitFrame = s.attackHitFrame;
+        e.attacking = s.attacking;
+        e.hasDealtDamageThisAttack = s.hasDealtDamageThisAttack;
+
+        hot.animFrame[slot] = s.animFrame;
+        e.animTimer = s.animTimer;
+        e.deathAnimFinished = s.deathAnimFinished;
+        e.deathJustFinished = s.deathJustFinished;
+
+        e.ambientSoundTimer = s.ambientSoundTimer;
+        e.loseSightTimer = s.loseSightTimer;
+        e.wanderAngle = s.wanderAngle;
+        e.wanderTimer = s.wanderTimer;
+        e.lateralOffset = s.lateralOffset;
+        e.rngState = s.rngState;
+
+        // Pointers are rebuilt, never stored in the snapshot
+        e.managerPtr = this;
+        e.syncSprite();
+
+        grid.insert(slot, s.x, s.y);
+
+        if (e.deathAnimFinished && !e.deathJustFinished)
+            retireCorpse(slot);
+    }
+
+    nextSpawnIndex = in.nextSpawnIndex;
+    spawnCounter = in.spawnCounter;
+    enemiesKilled = in.enemiesKilled;
+}
@@ -1,13 +1,22 @@
 #ifndef ENEMY_MANAGER_H
 #define ENEMY_MANAGER_H
 
+#include <algorithm>
 #include <vector>
 #include "Enemy.h"
 #include "PickupManager.h"
 #include "Map.h"
+#include "SpatialGrid.h"
+#include "FlowField.h"
+#include "Collision.h"
+#include "ProjectileManager.h"
+#include "WorkerPool.h"
+#include "../audio/AudioManager.h"
 #include <unordered_map>
 #include <SDL2/SDL.h>
 
+struct GameSnapshot;
+
 struct SpriteFrame {
     int w = 0;
     int h = 0;
@@ -23,35 +32,164 @@ struct EnemyVisual {
     std::unordered_map<EnemyAnimState, Animation> animations;
 };
 
+// Enemies whose death animation has finished. Only what the sprite pass
+// needs is kept, the slot itself goes straight back to the pool. Cleared
+// with the rest of the wave by deactivateAll().
+struct CorpseList {
+    std::vector<float> x;
+    std::vector<float> y;
+    std::vector<float> z;
+    std::vector<float> height;
+    std::vector<const SpriteFrame*> frame; // last death frame, owned by the manager's visuals
+
+    void add(float cx, float cy, float cz, float h, const SpriteFrame* f) {
+        x.push_back(cx);
+        y.push_back(cy);
+        z.push_back(cz);
+        height.push_back(h);
+        frame.push_back(f);
+    }
+
+    void clear() {
+        x.clear(); y.clear(); z.clear();
+        height.clear();
+        frame.clear();
+    }
+
+    int size() const { return (int)x.size(); }
+};
+
 class EnemyManager {
 public:
-    static const int MAX_ENEMIES = 128;
+    static constexpr int DEFAULT_CAPACITY = 1024;
 
-    struct SpawnPoint { int x, y; };
+    // Below this many enemies per job the thread handoff costs more than it saves
+    static constexpr int MIN_ENEMIES_PER_JOB = 32;
+
+    static constexpr float ENEMY_RADIUS = 0.25f; // wall collision footprint
 
-    EnemyManager();
+    // Simulation LOD. Enemies near or visible to the player run every frame,
+    // the next chunk over runs every REDUCED_INTERVAL frames (staggered by
+    // slot) and idle enemies further out sleep until the player comes close.
+    enum class SimTier { Full, Reduced, Asleep };
+    static constexpr int REDUCED_INTERVAL = 4;
+    static constexpr float WAKE_TIME = 3.0f; // full rate after being hit
 
-    Enemy enemies[MAX_ENEMIES];
+    struct SpawnPoint { int x, y; };
+
+    // threads: simulation workers besides the caller, 0 = one per spare core
+    explicit EnemyManager(int capacity = DEFAULT_CAPACITY, int threads = 0);
+
+    // Enemies point back at hot
+    EnemyManager(const EnemyManager&) = delete;
+    EnemyManager& operator=(const EnemyManager&) = delete;
+
+    int capacity() const { return (int)enemies.size(); }
+
+    // Per slot: the cold record (AI timers, combat stats, animation
+    // pointers) and the hot arrays (position, health, state, frame)
+    std::vector<Enemy> enemies;
+    EnemyHot hot;
+    CorpseList corpses;
+
+    // Active enemies bucketed by tile, ids are indices into enemies[]
+    SpatialGrid grid;
+
+    // Scratch for queries that gather slots from overlapping grid lookups
+    // (Hitscan). A slot is already gathered when its stamp equals epoch.
+    struct QueryScratch {
+        std::vector<uint32_t> stamp;
+        uint32_t epoch = 0;
+        std::vector<int> slots;
+
+        // Start a new query, clearing the gathered set in O(1)
+        void begin() {
+            slots.clear();
+            if (++epoch == 0) {
+                std::fill(stamp.begin(), stamp.end(), 0u);
+                epoch = 1;
+            }
+        }
+
+        void add(int slot) {
+            if (stamp[slot] == epoch) return;
+            stamp[slot] = epoch;
+            slots.push_back(slot);
+        }
+    };
+    mutable QueryScratch query;
+
+    // Shortest-path directions toward the player, shared by every enemy
+    FlowField flowField;
 
     std::unordered_map<EnemyType, EnemyVisual> enemyVisuals;
     std::unordered_map<EnemyType, EnemyVisual> enemyVisualsDamaged;
 
-    void scanMapForSpawnPoints(const Map& map);
+    // Spawn tiles come from the baked level, in the order enemies use them
+    void setSpawnPoints(const Map& map, const std::vector<std::pair<int,int>>& points);
     Enemy* spawnEnemy(EnemyType type);
 
     void loadEnemyAssets();
-    void update(float dt, const Player& player, PickupManager& pickupManager, const Map& map, AudioManager& audio);
+    // Enemies step in parallel, then their events are applied in a fixed
+    // order, so the outcome is the same for any thread count
+    void update(float dt, Player& player, PickupManager& pickupManager, const Map& map, AudioManager& audio,
+                ProjectileManager& projectiles);
+
+    // Dense list of active slots, in no particular order
+    const std::vector<int>& activeIndices() const { return activeList; }
+
+    // Damage through the manager so a hit also wakes the enemy
+    void damageEnemy(int slot, int amount);
 
     bool hasActiveEnemies() const;
     int getActiveEnemyCount() const;
     void deactivateAll();
 
+    // Deactivate everything and clear spawn rotation / kill count for a new run
+    void reset();
+
+    // Wave checkpoint save / restore of the enemy pool
+    void saveSnapshot(GameSnapshot& out) const;
+    void restoreSnapshot(const GameSnapshot& in);
+
     int enemiesKilled = 0;
 
 private:
     std::vector<SpawnPoint> spawnPoints;
     int nextSpawnIndex = 0;
-    void trySpawnAmmoDrop(const Enemy& e, const Player& player, PickupManager& pickupManager);
+    uint32_t spawnCounter = 0;     // feeds each spawned enemy's random seed
+
+    WorkerPool workers;
+    std::vector<EnemyEventBuffer> jobEvents; // one per job, reused every frame
+    std::vector<CollisionBatch> jobMoves;    // each job's moves, resolved in one pass
+    CollisionBatch separationMoves;
+
+    // Per slot LOD state
+    std::vector<float> pendingDt;  // time owed since the enemy last ran
+    std::vector<float> wakeTimer;  // > 0 forces full rate
+    std::vector<int> dueList;      // slots stepping this frame
+    uint32_t frameIndex = 0;
+
+    // Slot bookkeeping, all O(1)
+    std::vector<int> activeList;   // active slots
+    std::vector<int> activePos;    // slot -> index in activeList, -1 when free
+    std::vector<int> freeList;     // free slots, popped from the back
+
+    int allocateSlot();
+    void releaseSlot(int slot);
+    void retireCorpse(int slot);
+    uint32_t nextSeed();
+
+    SimTier classify(int slot, int playerChunk, int ptx, int pty, const Map& map) const;
+
+    void simulateEnemy(int slot, float dt, const Player& player, const Map& map,
+                       EnemyEventBuffer& events, CollisionBatch& moves);
+    void finishMove(int slot, const CollisionBatch& moves, int index, const Map& map);
+    void applyEvents(const EnemyEventBuffer& events, Player& player, AudioManager& audio,
+                     ProjectileManager& projectiles);
+
+    void trySpawnAmmoDrop(int slot, const Player& player, PickupManager& pickupManager);
+    void separateEnemies(const Map& map);
 };
 
 #endif
@@ -0,0 +1,121 @@
+#include "FlowField.h"
+#include "Map.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    constexpr float UNREACHED = 1e30f;
+    constexpr float DIAGONAL = 1.41421356f;
+
+    const int NX[8] = { 1, -1, 0, 0, 1, 1, -1, -1 };
+    const int NY[8] = { 0, 0, 1, -1, 1, -1, 1, -1 };
+}
+
+void FlowField::update(const Map& map, int tx, int ty) {
+    tx = std::clamp(tx, 0, map.width - 1);
+    ty = std::clamp(ty, 0, map.height - 1);
+
+    if (tx == targetX && ty == targetY && map.walkVersion == mapVersion &&
+        width == map.width && height == map.height)
+        return;
+
+    targetX = tx;
+    targetY = ty;
+    rebuild(map);
+}
+
+void FlowField::rebuild(const Map& map) {
+    if (width != map.width || height != map.height) {
+        width = map.width;
+        height = map.height;
+        int n = width * height;
+        walkable.resize(n);
+        cost.resize(n);
+        dirX.resize(n);
+        dirY.resize(n);
+        open.reserve(n * 4);
+        mapVersion = ~0u;
+    }
+
+    // Walkability changes are rare, only re-read it when the map says so
+    if (mapVersion != map.walkVersion) {
+        for (int y = 0; y < height; y++)
+            for (int x = 0; x < width; x++)
+                walkable[y * width + x] = map.isWalkable(x, y);
+        mapVersion = map.walkVersion;
+    }
+
+    std::fill(cost.begin(), cost.end(), UNREACHED);
+    std::fill(dirX.begin(), dirX.end(), 0.0f);
+    std::fill(dirY.begin(), dirY.end(), 0.0f);
+
+    // Dijkstra from the target, min-heap on cost
+    auto cmp = [](const std::pair<float, int>& a, const std::pair<float, int>& b) { return a.first > b.first; };
+    open.clear();
+
+    int start = targetY * width + targetX;
+    cost[start] = 0.0f;
+    open.push_back({ 0.0f, start });
+
+    while (!open.empty()) {
+        std::pop_heap(open.begin(), open.end(), cmp);
+        auto [c, idx] = open.back();
+        open.pop_back();
+
+        if (c > cost[idx]) continue; // stale entry
+
+        int x = idx % width;
+        int y = idx / width;
+
+        for (int k = 0; k < 8; k++) {
+            int nx = x + NX[k];
+            int ny = y + NY[k];
+            if (nx < 0 || ny < 0 || nx >= width || ny >= height) continue;
+
+            int n = ny * width + nx;
+            if (!walkable[n]) continue;
+
+            // No cutting corners past a blocked tile
+            bool diagonal = NX[k] != 0 && NY[k] != 0;
+            if (diagonal && (!walkable[y * width + nx] || !walkable[ny * width + x]))
+                continue;
+
+            float nc = c + (diagonal ? DIAGONAL : 1.0f);
+            if (nc < cost[n]) {
+                cost[n] = nc;
+
+                // Path from n leads back toward the tile we came from
+                float len = diagonal ? DIAGONAL : 1.0f;
+                dirX[n] = -NX[k] / len;
+                dirY[n] = -NY[k] / len;
+
+                open.push_back({ nc, n });
+                std::push_heap(open.begin(), open.end(), cmp);
+            }
+        }
+    }
+}
+
+bool FlowField::direction(float x, float y, float& outX, float& outY) const {
+    if (width == 0)
+        return false;
+
+    int tx = std::clamp(int(x), 0, width - 1);
+    int ty = std::clamp(int(y), 0, height - 1);
+    int idx = ty * width + tx;
+
+    if (cost[idx] <= 0.0f || cost[idx] >= UNREACHED)
+        return false;
+
+    outX = dirX[idx];
+    outY = dirY[idx];
+    return true;
+}
+
+float FlowField::distance(int x, int y) const {
+    if (width == 0 || x < 0 || y < 0 || x >= width || y >= height)
+        return -1.0f;
+
+    float c = cost[y * width + x];
+    return c >= UNREACHED ? -1.0f : c;
+}
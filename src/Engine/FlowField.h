@@ -0,0 +1,38 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+
+class Map;
+
+// Shared chase field for all enemies. One Dijkstra pass over the map grid,
+// seeded from the player's tile, gives every walkable tile a unit vector
+// pointing along the shortest path. Enemies just sample their own tile.
+class FlowField {
+public:
+    // Rebuilds only when the target tile or map walkability changed
+    void update(const Map& map, int targetX, int targetY);
+
+    // Steering direction for a world position. False when the tile is the
+    // target itself or has no path, the caller falls back to steering direct.
+    bool direction(float x, float y, float& outX, float& outY) const;
+
+    // Path length in tiles from (x, y) to the target, < 0 when unreachable
+    float distance(int x, int y) const;
+
+private:
+    int width = 0;
+    int height = 0;
+    int targetX = -1;
+    int targetY = -1;
+    unsigned mapVersion = ~0u;
+
+    std::vector<uint8_t> walkable;
+    std::vector<float> cost;
+    std::vector<float> dirX;
+    std::vector<float> dirY;
+
+    // Reused between rebuilds so recomputing never allocates
+    std::vector<std::pair<float, int>> open;
+
+    void rebuild(const Map& map);
+};
@@ -2,8 +2,10 @@
 #include "Renderer.h"
 #include "pItemRenderer.h"
 #include <algorithm>
+#include <cmath>
 #include <iostream>
 #include "TextureManager.h"
+#include "../Utils/PathUtils.h"
 
 struct DifficultyParams {
     float enemyCountMultiplier;
@@ -26,12 +28,25 @@ DifficultyParams getDifficultyParams(Difficulty d)
     }
 }
 
-GameSession::GameSession(Renderer& renderer, int screenW, int screenH, Difficulty diff) : difficulty(diff) {
-    initWorld(renderer, screenW);
+GameSession::GameSession(Renderer& renderer, int screenW, int screenH, Difficulty diff)
+    : GameSession(screenW, screenH) {
+    finalize(renderer, diff);
+}
+
+GameSession::GameSession(int screenW, int screenH) {
+    initWorld(screenW);
+    buildWaves();
 
     zBuffer = new float[screenW];
 
-    weaponManager.loadAssets(renderer.getSDLRenderer());
+    // Decode only, textures are created in finalize()
+    if (!weaponManager.decodeAssets()) {
+        std::cerr << "Failed to decode weapon assets\n";
+    }
+
+    if (!hud.decodeAssets()) {
+        std::cerr << "Failed to decode HUD assets\n";
+    }
 
     bulletHoleManager.loadVisual(
         BulletHoleType::Pistol, "Assets/geometry_textures/bulletHole.png"
@@ -41,14 +56,144 @@ GameSession::GameSession(Renderer& renderer, int screenW, int screenH, Difficult
         BulletHoleType::Shotgun, "Assets/geometry_textures/bulletHoleS.png"
     );
 
+    // Initialize enemy assets
+    enemyManager.loadEnemyAssets();
+
+    // Init pickup assets
+    pickupManager.loadPickupAssets();
+
+    doomRenderer->setPickupManager(pickupManager);
+    doomRenderer->setProjectileManager(projectileManager);
+    doomRenderer->setParticleSystem(particles);
+}
+
+void GameSession::finalize(Renderer& renderer, Difficulty diff) {
+    weaponManager.loadAssets(renderer.getSDLRenderer());
+
     if (!hud.init(renderer.getSDLRenderer())) {
         std::cerr << "Failed to initialize HUD\n";
     }
 
+    resetForNewRun(diff);
+}
+
+void GameSession::resetForNewRun(Difficulty diff) {
+    difficulty = diff;
+
+    // Mutable gameplay state only, assets / BSP / segments are kept
+    player.reset();
+    weapon = Weapon();
+    weaponManager.reset();
+    enemyManager.reset();
+    projectileManager.clear();
+    particles.clear();
+    bulletHoleManager.clear();
+
+    worldMap.resetHeights();
+    wallAnims.clear();
+
+    pickupManager.clear();
+
+    pickupManager.addPickup(23.5f, 2.5f, 0.0f, PickupType::Health, WeaponType::None);
+
+    pickupManager.addPickup(5.5f, 2.5f, 0.0f, PickupType::Weapon, WeaponType::Pistol);
+
+    applyWaveDifficulty();
+
+    currentWaveIndex = -1;
+    enemiesSpawned = 0;
+    spawnTimer = 0.0f;
+    exit_spawn = false;
+
+    snapshotHead = 0;
+    snapshotCount = 0;
+
+    // Start in post-wave delay so wave 1 begins after 5s
+    waveState = WaveState::PostWaveDelay;
+    postWaveTimer = 0.0f;
+
+    snapInterpolation();
+}
+
+bool GameSession::retryWave() {
+    if (snapshotCount == 0)
+        return false;
+
+    int newest = (snapshotHead + SNAPSHOT_RING_SIZE - 1) % SNAPSHOT_RING_SIZE;
+    restoreSnapshot(snapshots[newest]);
+    return true;
+}
+
+void GameSession::saveSnapshot(GameSnapshot& snap) const {
+    player.saveSnapshot(snap.player);
+    snap.weapon = weapon;
+
+    enemyManager.saveSnapshot(snap);
+    pickupManager.saveSnapshot(snap);
+
+    snap.heightCount = 0;
+    for (int y = 0; y < worldMap.height; y++) {
+        for (int x = 0; x < worldMap.width; x++) {
+            float h = worldMap.get(x, y).height;
+            if (h == worldMap.baseHeightAt(x, y)) continue;
+
+            if (snap.heightCount == GameSnapshot::MAX_HEIGHT_CHANGES) {
+                std::cerr << "Snapshot height list full, some walls will reset on retry\n";
+                break;
+            }
+            snap.heights[snap.heightCount++] = { x, y, h };
+        }
+    }
+
+    snap.wallAnimCount = std::min((int)wallAnims.size(), GameSnapshot::MAX_WALL_ANIMS);
+    std::copy_n(wallAnims.begin(), snap.wallAnimCount, snap.wallAnims);
+
+    snap.currentWaveIndex = currentWaveIndex;
+    snap.enemiesSpawned = (int)enemiesSpawned;
+    snap.spawnTimer = spawnTimer;
+    snap.postWaveTimer = postWaveTimer;
+    snap.waveState = (int)waveState;
+    snap.exitSpawn = exit_spawn;
+}
+
+void GameSession::restoreSnapshot(const GameSnapshot& snap) {
+    player.restoreSnapshot(snap.player);
+    weapon = snap.weapon;
+    weaponManager.reset();
+
+    enemyManager.restoreSnapshot(snap);
+    pickupManager.restoreSnapshot(snap);
+    projectileManager.clear();
+    particles.clear();
+    bulletHoleManager.clear();
+
+    for (int y = 0; y < worldMap.height; y++)
+        for (int x = 0; x < worldMap.width; x++)
+            worldMap.setHeight(x, y, worldMap.baseHeightAt(x, y));
+
+    for (int i = 0; i < snap.heightCount; i++)
+        worldMap.setHeight(snap.heights[i].x, snap.heights[i].y, snap.heights[i].height);
+    worldMap.refreshVisibility();
+
+    wallAnims.assign(snap.wallAnims, snap.wallAnims + snap.wallAnimCount);
+
+    currentWaveIndex = snap.currentWaveIndex;
+    enemiesSpawned = snap.enemiesSpawned;
+    spawnTimer = snap.spawnTimer;
+    postWaveTimer = snap.postWaveTimer;
+    waveState = (WaveState)snap.waveState;
+    exit_spawn = snap.exitSpawn;
+
+    snapInterpolation();
+}
+
+void GameSession::buildWaves() {
+    waveDefs.clear();
+
     // Wave defs (temp)
 
     // Wave 1
-    waves.push_back({
+    waveDefs.push_back({
         6.0f, // spawn interval
         {
             EnemyType::Base, EnemyType::Base, EnemyType::Base, EnemyType::Fast,
@@ -57,7 +202,7 @@ GameSession::GameSession(Renderer& renderer, int screenW, int screenH, Difficult
     });
 
     // Wave 2
-    waves.push_back({
+    waveDefs.push_back({
         5.0f, // spawn interval
         {
             EnemyType::Base, EnemyType::Fast, EnemyType::Base, EnemyType::Fast, 
@@ -66,7 +211,7 @@ GameSession::GameSession(Renderer& renderer, int screenW, int screenH, Difficult
     });
 
     // Wave 3
-    waves.push_back({
+    waveDefs.push_back({
         5.0f, // spawn interval
         {
             EnemyType::Base, EnemyType::Shooter, EnemyType::Fast, EnemyType::Fast, 
@@ -76,7 +221,7 @@ GameSession::GameSession(Renderer& renderer, int screenW, int screenH, Difficult
     });  
 
     // Wave 4
-    waves.push_back({
+    waveDefs.push_back({
         5.0f, // spawn interval
         {
             EnemyType::Fast, EnemyType::Shooter, EnemyType::Base, EnemyType::Shooter,
@@ -86,19 +231,38 @@ GameSession::GameSession(Renderer& renderer, int screenW, int screenH, Difficult
     });
 
     // Wave 5
-    waves.push_back({
+    waveDefs.push_back({
         5.0f, // spawn interval
         {
             EnemyType::Tank, EnemyType::Tank, EnemyType::Tank
         }
     });
 
+    // Room for the largest difficulty scaling, so applyWaveDifficulty() never allocates
+    waves = waveDefs;
+    for (size_t i = 0; i < waves.size(); i++) {
+        size_t most = waveDefs[i].enemies.size();
+        for (Difficulty d : { Difficulty::Easy, Difficulty::Medium, Difficulty::Hard }) {
+            float scaled = std::round(waveDefs[i].enemies.size() * getDifficultyParams(d).enemyCountMultiplier);
+            most = std::max(most, (size_t)std::max(1.0f, scaled));
+        }
+        waves[i].enemies.reserve(most);
+    }
+}
+
+void GameSession::applyWaveDifficulty() {
     DifficultyParams params = getDifficultyParams(difficulty);
 
-    for (auto& wave : waves)
+    for (size_t i = 0; i < waves.size(); i++)
     {
+        Wave& wave = waves[i];
+        const Wave& def = waveDefs[i];
+
         // Scale spawn rate
-        wave.spawnInterval *= params.spawnIntervalMultiplier;
+        wave.spawnInterval = def.spawnInterval * params.spawnIntervalMultiplier;
+
+        // Start over from the definition, within the reserved capacity
+        wave.enemies.assign(def.enemies.begin(), def.enemies.end());
 
         // Scale enemy count
         int originalCount = static_cast<int>(wave.enemies.size());
@@ -122,34 +286,39 @@ GameSession::GameSession(Renderer& renderer, int screenW, int screenH, Difficult
             wave.enemies.resize(targetCount);
         }
     }
-
-    // Initialize enemy assets
-    enemyManager.loadEnemyAssets();
-
-    // Init pickup assets
-    pickupManager.loadPickupAssets();
-
-    pickupManager.addPickup(23.5f, 2.5f, 0.0f, PickupType::Health, WeaponType::None);
-
-    pickupManager.addPickup(5.5f, 2.5f, 0.0f, PickupType::Weapon, WeaponType::Pistol);
-
-    doomRenderer->setPickupManager(pickupManager);
-
-    // Start in post-wave delay so wave 1 begins after 5s
-    waveState = WaveState::PostWaveDelay;
-    postWaveTimer = 0.0f;
 }
 
 GameSession::~GameSession() {
     delete[] zBuffer;
 }
 
-void GameSession::initWorld(Renderer& renderer, int screenW) {
-    enemyManager.scanMapForSpawnPoints(worldMap);
+void GameSession::initWorld(int screenW) {
+    LevelData level;
+    bool baked = readLevelFile(resolvePath(LEVEL_PATH), level);
+    if (!baked)
+        std::cerr << "No baked level at " << LEVEL_PATH << ", compiling " << LEVEL_SOURCE_PATH << "\n";
+
+    // An edited source next to an old bake wins. No source shipped: trust the bake.
+    uint64_t sourceHash = 0;
+    bool haveSource = hashLevelSource(resolvePath(LEVEL_SOURCE_PATH), sourceHash);
+    if (baked && haveSource && sourceHash != level.sourceHash) {
+        std::cerr << LEVEL_PATH << " does not match " << LEVEL_SOURCE_PATH << ", compiling the source\n";
+        baked = false;
+    }
+
+    if (!baked) {
+        if (!worldMap.loadFromFile(resolvePath(LEVEL_SOURCE_PATH), false)) {
+            std::cerr << "Failed to load level " << LEVEL_SOURCE_PATH << "\n";
+        }
+        compileLevel(worldMap, level);
+    }
+
+    applyLevel(level, worldMap);
 
-    segments = buildSegmentsFromGrid(worldMap);
-    bspRoot = buildBSP(segments);
-    doomRenderer = std::make_unique<DoomRenderer>(segments, std::move(bspRoot));
+    enemyManager.setSpawnPoints(worldMap, level.spawnPoints);
+    pickupManager.setWorldSize(worldMap.width, worldMap.height);
+
+    doomRenderer = std::make_unique<DoomRenderer>(std::move(level.bspNodes), std::move(level.bspSegments));
 }
 
 void GameSession::startWave(int index) {
@@ -160,20 +329,15 @@ void GameSession::startWave(int index) {
 }
 
 void GameSession::startWaveWallAnimations(int waveIndex, AudioManager& audio) {
-    audio.playSFX("wall_slide");
+    audio.playSFX(SfxId::WallSlide);
     // Wave 0 (wave one)
     if (waveIndex == 0) {
 
         // Tiles to animate
-        const std::vector<std::pair<int,int>> tiles = {
-            {14, 4},
-            {14, 5},
-            {15, 4},
-            {15, 5}
-        };
+        const auto& tiles = worldMap.getTileGroup("start");
 
         for (auto& [x, y] : tiles) {
-            auto& tile = worldMap.get(x, y);
+            const Map::Cell tile = worldMap.get(x, y);
 
             WallHeightAnim anim;
             anim.x = x;
@@ -191,14 +355,10 @@ void GameSession::startWaveWallAnimations(int waveIndex, AudioManager& audio) {
     else if (waveIndex == 1) {
         
         // Tiles to animate
-        const std::vector<std::pair<int,int>> tiles = {
-            {24, 7},
-            {24, 8},  
-            {24, 9}
-        };
+        const auto& tiles = worldMap.getTileGroup("wave1");
         
         for (auto& [x, y] : tiles) {
-            auto& tile = worldMap.get(x, y);
+            const Map::Cell tile = worldMap.get(x, y);
             
             WallHeightAnim anim;
             anim.x = x;
@@ -218,14 +378,10 @@ void GameSession::startWaveWallAnimations(int waveIndex, AudioManager& audio) {
     else if (waveIndex == 2) {
             
         // Tiles to animate
-        const std::vector<std::pair<int,int>> tiles = {
-            {24, 20},
-            {24, 21},
-            {24, 22}
-        };  
+        const auto& tiles = worldMap.getTileGroup("wave2");
             
         for (auto& [x, y] : tiles) {
-            auto& tile = worldMap.get(x, y);
+            const Map::Cell tile = worldMap.get(x, y);
             
             WallHeightAnim anim;
             anim.x = x;
@@ -246,14 +402,10 @@ void GameSession::startWaveWallAnimations(int waveIndex, AudioManager& audio) {
     else if (waveIndex == 3) {
             
         // Tiles to animate
-        const std::vector<std::pair<int,int>> tiles = {
-            {5, 7},
-            {5, 8},
-            {5, 9}
-        };  
+        const auto& tiles = worldMap.getTileGroup("wave3");
             
         for (auto& [x, y] : tiles) {
-            auto& tile = worldMap.get(x, y);
+            const Map::Cell tile = worldMap.get(x, y);
             
             WallHeightAnim anim;
             anim.x = x;
@@ -273,14 +425,10 @@ void GameSession::startWaveWallAnimations(int waveIndex, AudioManager& audio) {
     else if (waveIndex == 4) {
             
         // Tiles to animate
-        const std::vector<std::pair<int,int>> tiles = {
-            {5, 20},
-            {5, 21},
-            {5, 22}
-        };  
+        const auto& tiles = worldMap.getTileGroup("wave4");
             
         for (auto& [x, y] : tiles) {
-            auto& tile = worldMap.get(x, y);
+            const Map::Cell tile = worldMap.get(x, y);
             
             WallHeightAnim anim;
             anim.x = x;
@@ -301,13 +449,10 @@ void GameSession::startWaveWallAnimations(int waveIndex, AudioManager& audio) {
     else if (waveIndex == 5) {
             
         // Tiles to animate
-        const std::vector<std::pair<int,int>> tiles = {
-            {14, 24},
-            {15, 24},
-        };
+        const auto& tiles = worldMap.getTileGroup("wave5");
           
         for (auto& [x, y] : tiles) {
-            auto& tile = worldMap.get(x, y);
+            const Map::Cell tile = worldMap.get(x, y);
             
             WallHeightAnim anim;
             anim.x = x;
@@ -325,15 +470,10 @@ void GameSession::startWaveWallAnimations(int waveIndex, AudioManager& audio) {
     else if (waveIndex == 100) {
     
         // Tiles to animate
-        const std::vector<std::pair<int,int>> tiles = {
-            {14, 4},
-            {14, 5},
-            {15, 4},
-            {15, 5}
-        };
+        const auto& tiles = worldMap.getTileGroup("start");
             
         for (auto& [x, y] : tiles) {
-            auto& tile = worldMap.get(x, y);
+            const Map::Cell tile = worldMap.get(x, y);
         
             WallHeightAnim anim;
             anim.x = x;
@@ -363,13 +503,16 @@ void GameSession::updateWallAnimations(float dt, AudioManager& audio) {
             anim.startHeight +
             (anim.targetHeight - anim.startHeight) * t;
 
-        worldMap.get(anim.x, anim.y).height = height;
+        worldMap.setHeight(anim.x, anim.y, height);
 
         if (anim.progress >= 1.0f) {
             anim.finished = true;
         }
     }
 
+    // Line of sight only re-traces if a wall crossed a height class
+    worldMap.refreshVisibility();
+
     // cleanup
     wallAnims.erase(
         std::remove_if(wallAnims.begin(), wallAnims.end(),
@@ -378,12 +521,122 @@ void GameSession::updateWallAnimations(float dt, AudioManager& audio) {
     );
 }
 
+void GameSession::advance(float frameDt, const Uint8* keys, GameState& gameState, AudioManager& audio) {
+    tickAccumulator += frameDt;
+
+    int ticks = 0;
+    while (tickAccumulator >= TICK) {
+        if (ticks == MAX_TICKS_PER_FRAME) {
+            // Too far behind (hitch, window drag), drop the backlog
+            tickAccumulator = std::fmod(tickAccumulator, TICK);
+            break;
+        }
+
+        recordPrevious();
+        update(TICK, keys, gameState, audio);
+        tickAccumulator -= TICK;
+        ticks++;
+
+        // Paused, died or finished the level, the remaining time is not owed
+        // and the frozen frame shows the state as it is
+        if (gameState != GameState::Playing) {
+            snapInterpolation();
+            break;
+        }
+    }
+}
+
+void GameSession::recordPrevious() {
+    prevPlayer = { player.x, player.y, player.z, player.angle };
+
+    const EnemyHot& hot = enemyManager.hot;
+    prevEnemyX = hot.x;
+    prevEnemyY = hot.y;
+    prevEnemyZ = hot.z;
+}
+
+void GameSession::snapInterpolation() {
+    tickAccumulator = 0.0f;
+    recordPrevious();
+}
+
+GameSession::ViewTransform GameSession::beginInterpolatedView() {
+    ViewTransform saved = { player.x, player.y, player.z, player.angle };
+
+    float alpha = std::clamp(tickAccumulator / TICK, 0.0f, 1.0f);
+    float back = 1.0f - alpha;
+
+    // Anything that moved more than a tile in one tick was teleported, draw it where it is
+    auto jumped = [](float dx, float dy) { return dx*dx + dy*dy > 1.0f; };
+
+    if (!jumped(player.x - prevPlayer.x, player.y - prevPlayer.y)) {
+        player.x -= (player.x - prevPlayer.x) * back;
+        player.y -= (player.y - prevPlayer.y) * back;
+        player.z -= (player.z - prevPlayer.z) * back;
+
+        // Shortest way round
+        float da = std::remainder(player.angle - prevPlayer.angle, 6.2831853f);
+        player.angle -= da * back;
+    }
+
+    EnemyHot& hot = enemyManager.hot;
+    viewEnemyX = hot.x;
+    viewEnemyY = hot.y;
+    viewEnemyZ = hot.z;
+
+    if (prevEnemyX.size() == hot.x.size()) {
+        for (int i : enemyManager.activeIndices()) {
+            float dx = hot.x[i] - prevEnemyX[i];
+            float dy = hot.y[i] - prevEnemyY[i];
+            if (jumped(dx, dy))
+                continue;
+
+            viewEnemyX[i] -= dx * back;
+            viewEnemyY[i] -= dy * back;
+            viewEnemyZ[i] -= (hot.z[i] - prevEnemyZ[i]) * back;
+        }
+    }
+
+    std::swap(hot.x, viewEnemyX);
+    std::swap(hot.y, viewEnemyY);
+    std::swap(hot.z, viewEnemyZ);
+
+    projectileManager.viewAlpha = alpha;
+    particles.viewAlpha = alpha;
+
+    return saved;
+}
+
+void GameSession::endInterpolatedView(const ViewTransform& saved) {
+    EnemyHot& hot = enemyManager.hot;
+    std::swap(hot.x, viewEnemyX);
+    std::swap(hot.y, viewEnemyY);
+    std::swap(hot.z, viewEnemyZ);
+
+    projectileManager.viewAlpha = 1.0f;
+    particles.viewAlpha = 1.0f;
+
+    player.x = saved.x;
+    player.y = saved.y;
+    player.z = saved.z;
+    player.angle = saved.angle;
+}
+
 void GameSession::update(float dt, const Uint8* keys, GameState& gameState, AudioManager& audio) {
-    player.update(dt, keys, worldMap, enemyManager, weaponManager, weapon, gameState, audio, bulletHoleManager);
-    enemyManager.update(dt, player, pickupManager, worldMap, audio);
+    player.update(dt, keys, worldMap, enemyManager, weaponManager, weapon, gameState, audio, bulletHoleManager, particles);
+
+    // Enemy sounds are positional, relative to where the player is this frame
+    audio.setListener(player.x, player.y, player.angle);
+    enemyManager.update(dt, player, pickupManager, worldMap, audio, projectileManager);
+    projectileManager.update(dt, worldMap, player, particles);
+
     pickupManager.update(player, dt, weapon, audio);
     weaponManager.update(dt, player);
     bulletHoleManager.update(dt);
+
+    particles.emitLavaEmbers(worldMap, player.x, player.y, dt);
+    particles.update(dt, worldMap);
+
     updateWallAnimations(dt, audio);
 
     if (currentWaveIndex >= (int)waves.size())
@@ -439,6 +692,12 @@ void GameSession::update(float dt, const Uint8* keys, GameState& gameState, Audi
                 waveState = WaveState::Spawning;
 
                 startWaveWallAnimations(currentWaveIndex, audio);
+
+                // Checkpoint after the wave start side effects so a retry
+                // does not need to replay them
+                saveSnapshot(snapshots[snapshotHead]);
+                snapshotHead = (snapshotHead + 1) % SNAPSHOT_RING_SIZE;
+                snapshotCount = std::min(snapshotCount + 1, SNAPSHOT_RING_SIZE);
             }
             break;
         }
@@ -448,10 +707,12 @@ void GameSession::update(float dt, const Uint8* keys, GameState& gameState, Audi
 void GameSession::render(Renderer& renderer, uint32_t* pixels, int w, int h, TextureManager& textureManager) {
     std::fill(pixels, pixels + w * h, 0xFF202020);
 
+    ViewTransform saved = beginInterpolatedView();
     doomRenderer->render(
         pixels, w, h,
         player, worldMap, zBuffer, enemyManager, textureManager, bulletHoleManager
     );
+    endInterpolatedView(saved);
 
     player.renderDamageFlash(pixels, w, h, player.damageFlashIntensity);
 
@@ -504,10 +765,12 @@ void GameSession::renderPaused(
     float pauseT,
     TextureManager& textureManager
 ) {
+    ViewTransform saved = beginInterpolatedView();
     doomRenderer->render(
         pixels, w, h,
         player, worldMap, zBuffer, enemyManager, textureManager, bulletHoleManager
     );
+    endInterpolatedView(saved);
 
     player.renderDamageFlash(pixels, w, h, player.damageFlashIntensity);
 
@@ -8,12 +8,14 @@
 #include "BulletHoleManager.h"
 #include "WeaponTypes.h"
 #include "HUD.h"
-#include "MapToSegments.h"
-#include "BSP.h"
+#include "LevelFile.h"
 #include "DoomRenderer.h"
 #include "GameState.h"
+#include "Wave.h"
+#include "GameSnapshot.h"
 #include "../settings/GameSettings.h"
 
+#include <array>
 #include <memory>
 #include <vector>
 #include <SDL2/SDL.h>
@@ -22,35 +24,39 @@ class Renderer;
 
 class TextureManager;
 
-struct Wave {
-    float spawnInterval;
-    std::vector<EnemyType> enemies;
-};
+class GameSession {
+public:
+    GameSession(Renderer& renderer, int screenW, int screenH, Difficulty diff);
 
-struct WallHeightAnim {
-    int x;
-    int y;
+    // Preparation phase: decodes assets and loads the baked level.
+    // Never touches the SDL renderer, so it is safe to run on a background thread.
+    GameSession(int screenW, int screenH);
 
-    float startHeight;
-    float targetHeight;
+    // Finalize phase (main thread): creates SDL textures and applies difficulty
+    void finalize(Renderer& renderer, Difficulty diff);
 
-    float progress;   // 0.0, 1.0
-    float speed;      // units per second
+    // Start a new run on an already finalized session. Keeps textures,
+    // animations, segments and BSP, restores only the mutable game state.
+    void resetForNewRun(Difficulty diff);
 
-    bool finished = false;
-};
+    // Restore the snapshot taken at the start of the current wave.
+    // Returns false if no wave has started yet.
+    bool retryWave();
 
-class GameSession {
-public:
-    GameSession(Renderer& renderer, int screenW, int screenH, Difficulty diff);
     ~GameSession();
 
+    // Simulation runs at a fixed rate. advance() consumes the frame time in
+    // TICK steps and render() draws between the last two ticks.
+    static constexpr float TICK = 1.0f / 120.0f;
+    static constexpr int MAX_TICKS_PER_FRAME = 12; // past this the game slows down instead of spiralling
+
+    void advance(float frameDt, const Uint8* keys, GameState& gameState, AudioManager& audio);
     void update(float dt, const Uint8* keys, GameState& gameState, AudioManager& audio);
     void render(Renderer& renderer, uint32_t* pixels, int screenW, int screenH, TextureManager& textureManager);
 
     void renderPaused(Renderer& renderer, uint32_t* pixels, int screenW, int screenH, float pauseT, TextureManager& textureManager);
 
-    std::vector<Wave> waves;
+    std::vector<Wave> waves;      // waveDefs scaled to the current difficulty
     std::vector<WallHeightAnim> wallAnims;
     int currentWaveIndex = -1;
 
@@ -58,7 +64,7 @@ public:
     Player player;
     EnemyManager enemyManager;
 
-    Difficulty difficulty;
+    Difficulty difficulty = Difficulty::Medium;
 
 private:
     // Core gameplay state
@@ -67,18 +73,27 @@ private:
     WeaponManager weaponManager;
     Weapon weapon;
     BulletHoleManager bulletHoleManager;
+    ProjectileManager projectileManager;
+    ParticleSystem particles;
     HUD hud;
 
     // BSP world rendering
-    std::vector<GridSegment> segments;
-    std::unique_ptr<BSPNode> bspRoot;
     std::unique_ptr<DoomRenderer> doomRenderer;
 
     float* zBuffer = nullptr;
 
-    void initWorld(Renderer& renderer, int screenW);
+    // Baked by LevelCompiler at build time, the source is only compiled
+    // in-process when the baked file is missing, from another format
+    // version, or was baked from a different copy of the source
+    static constexpr const char* LEVEL_PATH = "Assets/Levels/level1.bin";
+    static constexpr const char* LEVEL_SOURCE_PATH = "Assets/Levels/level1.lvl";
+
+    void initWorld(int screenW);
 
-    // Wave control 
+    // Wave control
+    std::vector<Wave> waveDefs;   // unscaled, built once
+    void buildWaves();
+    void applyWaveDifficulty();   // refill waves from waveDefs, no allocation
     void startWave(int index);
 
     float spawnTimer = 0.0f;
@@ -99,4 +114,27 @@ private:
 
     bool exit_spawn = false;
 
+    // Wave start checkpoints (ring buffer, newest at snapshotHead - 1)
+    static constexpr int SNAPSHOT_RING_SIZE = 4;
+    std::array<GameSnapshot, SNAPSHOT_RING_SIZE> snapshots;
+    int snapshotHead = 0;
+    int snapshotCount = 0;
+
+    void saveSnapshot(GameSnapshot& snap) const;
+    void restoreSnapshot(const GameSnapshot& snap);
+
+    // Render interpolation, state as of the previous tick
+    struct ViewTransform { float x, y, z, angle; };
+
+    float tickAccumulator = 0.0f;
+    ViewTransform prevPlayer{};
+    std::vector<float> prevEnemyX, prevEnemyY, prevEnemyZ;
+    std::vector<float> viewEnemyX, viewEnemyY, viewEnemyZ;
+
+    void recordPrevious();
+    void snapInterpolation();
+
+    // Swap interpolated transforms in for drawing, end puts the real ones back
+    ViewTransform beginInterpolatedView();
+    void endInterpolatedView(const ViewTransform& saved);
 };
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <cstdint>
+#include <type_traits>
+#include "Map.h"
+#include "Player.h"
+#include "EnemyManager.h"
+#include "PickupManager.h"
+#include "WeaponTypes.h"
+#include "Wave.h"
+
+// -----------------------------
+// Flat, pointer free copies of the mutable simulation state.
+// Everything here is trivially copyable so a snapshot can be
+// memcpy'd, written to disk or kept in a ring buffer as is.
+// -----------------------------
+
+struct PlayerSnapshot {
+    static constexpr int MAX_INVENTORY = 8;
+
+    int health;
+    int armor;
+
+    float x, y, z;
+    float angle;
+    float velX, velY, velZ;
+    float turnVel;
+    float baseZ;
+    bool onGround;
+
+    ItemType currentItem;
+    ItemType inventory[MAX_INVENTORY];
+    int inventoryCount;
+
+    // Stats
+    int shotsFired;
+    int shotsHit;
+    float timeElapsed;
+};
+
+struct EnemySnapshot {
+    float x, y, z;
+    float height;
+    float speed;
+    float angle;
+
+    EnemyType type;
+    EnemyState state;
+    EnemyAnimState animState;
+
+    int health;
+    int maxHealth;
+
+    float attackRange;
+    int attackDamage;
+    float attackCooldown;
+    float attackTimer;
+    int attackHitFrame;
+    bool attacking;
+    bool hasDealtDamageThisAttack;
+
+    int animFrame;
+    float animTimer;
+    bool deathAnimFinished;
+    bool deathJustFinished;
+
+    float ambientSoundTimer;
+    float loseSightTimer;
+    float wanderAngle;
+    float wanderTimer;
+    float lateralOffset;
+    uint32_t rngState;
+};
+
+// A tile whose height differs from the level as authored
+struct HeightSnapshot {
+    int x, y;
+    float height;
+};
+
+struct PickupSnapshot {
+    float x, y, z;
+    PickupType type;
+    WeaponType id;
+};
+
+struct GameSnapshot {
+    static constexpr int MAX_WALL_ANIMS = 32;
+
+    // Active enemies only, packed. Checkpoints are taken between waves
+    // so this is far more than ever needed.
+    static constexpr int MAX_ENEMIES = 256;
+
+    PlayerSnapshot player;
+    Weapon weapon;
+
+    EnemySnapshot enemies[MAX_ENEMIES];
+    int enemyCount;
+    int nextSpawnIndex;
+    uint32_t spawnCounter;
+    int enemiesKilled;
+
+    PickupSnapshot pickups[PickupManager::MAX_PICKUPS];
+    int pickupCount;
+
+    // Only tiles moved by wall animations, the rest match the level file
+    static constexpr int MAX_HEIGHT_CHANGES = 256;
+    HeightSnapshot heights[MAX_HEIGHT_CHANGES];
+    int heightCount;
+
+    WallHeightAnim wallAnims[MAX_WALL_ANIMS];
+    int wallAnimCount;
+
+    // Wave counters
+    int currentWaveIndex;
+    int enemiesSpawned;
+    float spawnTimer;
+    float postWaveTimer;
+    int waveState;
+    bool exitSpawn;
+};
+
+static_assert(std::is_trivially_copyable_v<GameSnapshot>,
+              "GameSnapshot must stay a flat POD");
@@ -3,31 +3,92 @@
 #include "../third_party/stb_image_wrapper.h"
 #include "../Utils/PathUtils.h"
 
-bool HUD::init(SDL_Renderer* renderer) {
+bool HUD::decodeAssets() {
+    if (decoded) return true;
+
     std::string path;
     std::string fullPath;
-    SDL_Surface* surface;
 
     // Load digits 0-9 + "/"
     for (int i = 0; i < 11; ++i) {
         path = "Assets/pixDigit/pixelDigit-" + std::to_string(i) + ".png";
         fullPath = resolvePath(path);
-        surface = LoadSurfaceFromPNG(fullPath.c_str());
-        if (!surface) {
+        digitSurfaces[i] = LoadSurfaceFromPNG(fullPath.c_str());
+        if (!digitSurfaces[i]) {
             std::cerr << "Failed to load digit " << i
                       << " from path: " << path << "\n";
+            freeSurfaces();
             return false;
         }
+    }
+
+    // Load Wave PNG
+    path = "Assets/pixWords/wave.png";
+    fullPath = resolvePath(path);
+    waveTextSurface = LoadSurfaceFromPNG(fullPath.c_str());
+    if (!waveTextSurface) {
+        std::cerr << "Failed to load wave.png\n";
+        freeSurfaces();
+        return false;
+    }
+
+    // Load Enemies Left PNG
+    path = "assets/pixWords/enemiesLeft.png";
+    fullPath = resolvePath(path);
+    enemiesLeftTextSurface = LoadSurfaceFromPNG(fullPath.c_str());
+    if (!enemiesLeftTextSurface) {
+        std::cerr << "Failed to load enemiesLeft.png\n";
+        freeSurfaces();
+        return false;
+    }
+
+    // Load Wave Starting In PNG
+    path = "assets/pixWords/waveStarting.png";
+    fullPath = resolvePath(path);
+    waveStartingTextSurface = LoadSurfaceFromPNG(fullPath.c_str());
+    if (!waveStartingTextSurface) {
+        std::cerr << "Failed to load waveStarting.png\n";
+        freeSurfaces();
+        return false;
+    }
 
+    decoded = true;
+    return true;
+}
+
+void HUD::freeSurfaces() {
+    for (SDL_Surface*& surface : digitSurfaces) {
+        if (surface) FreeSurface(surface);
+        surface = nullptr;
+    }
+
+    for (SDL_Surface** surface : { &waveTextSurface, &enemiesLeftTextSurface, &waveStartingTextSurface }) {
+        if (*surface) FreeSurface(*surface);
+        *surface = nullptr;
+    }
+
+    decoded = false;
+}
+
+bool HUD::init(SDL_Renderer* renderer) {
+    if (!decoded && !decodeAssets())
+        return false;  // decodeAssets() already cleaned up
+
+    // Upload a decoded surface and release it
+    auto upload = [&](SDL_Surface*& surface) {
         SDL_Texture* tex = SDL_CreateTextureFromSurface(renderer, surface);
-        SDL_FreeSurface(surface);
+        FreeSurface(surface);
+        surface = nullptr;
+        return tex;
+    };
 
-        if (!tex) {
+    for (int i = 0; i < 11; ++i) {
+        digitTextures[i] = upload(digitSurfaces[i]);
+        if (!digitTextures[i]) {
             std::cerr << "Failed to create texture for digit " << i << "\n";
+            freeSurfaces();
             return false;
         }
-
-        digitTextures[i] = tex;
     }
 
     // Query width/height from first digit for layout
@@ -35,51 +96,28 @@ bool HUD::init(SDL_Renderer* renderer) {
         SDL_QueryTexture(digitTextures[0], nullptr, nullptr, &digitW, &digitH);
     }
 
-    // Load Wave PNG
-    path = "Assets/pixWords/wave.png";
-    fullPath = resolvePath(path);
-    surface = LoadSurfaceFromPNG(fullPath.c_str());
-    if (!surface) {
-        std::cerr << "Failed to load wave.png\n";
-        return false;
-    }
-    waveTextTexture = SDL_CreateTextureFromSurface(renderer, surface);
-    SDL_FreeSurface(surface);
+    waveTextTexture = upload(waveTextSurface);
     if (!waveTextTexture) {
         std::cerr << "Failed to create wave texture\n";
+        freeSurfaces();
         return false;
     }
 
-    // Load Enemies Left PNG
-    path = "assets/pixWords/enemiesLeft.png";
-    fullPath = resolvePath(path);
-    surface = LoadSurfaceFromPNG(fullPath.c_str());
-    if (!surface) {
-        std::cerr << "Failed to load enemiesLeft.png\n";
-        return false;
-    }
-    enemiesLeftTextTexture = SDL_CreateTextureFromSurface(renderer, surface);
-    SDL_FreeSurface(surface);
+    enemiesLeftTextTexture = upload(enemiesLeftTextSurface);
     if (!enemiesLeftTextTexture) {
         std::cerr << "Failed to create enemiesLeft texture\n";
+        freeSurfaces();
         return false;
     }
 
-    // Load Wave Starting In PNG
-    path = "assets/pixWords/waveStarting.png";
-    fullPath = resolvePath(path);
-    surface = LoadSurfaceFromPNG(fullPath.c_str());
-    if (!surface) {
-        std::cerr << "Failed to load waveStarting.png\n";
-        return false;    
-    }
-    waveStartingTextTexture = SDL_CreateTextureFromSurface(renderer, surface);
-    SDL_FreeSurface(surface);
+    waveStartingTextTexture = upload(waveStartingTextSurface);
     if (!waveStartingTextTexture) {
         std::cerr << "Failed to create waveStarting texture\n";
+        freeSurfaces();
         return false;
     }
 
+    decoded = false;
     return true;
 }
 
@@ -11,6 +11,17 @@ struct AmmoTickStyle {
 
 class HUD {
 public:
+    HUD() = default;
+    ~HUD() { freeSurfaces(); }
+
+    // Owns decoded surfaces until init() uploads them
+    HUD(const HUD&) = delete;
+    HUD& operator=(const HUD&) = delete;
+
+    // Decode HUD images into surfaces (no renderer needed, safe off the main thread)
+    bool decodeAssets();
+
+    // Create HUD textures (main thread). Decodes first if needed.
     bool init(SDL_Renderer* renderer);
 
     void render(SDL_Renderer* renderer,
@@ -72,6 +83,16 @@ private:
     AmmoTickStyle shotgunTicks { 8, 22, 5 };
     AmmoTickStyle mgTicks   { 2, 18, 2 };
 
+    // Surfaces decoded by decodeAssets(), waiting for init() to upload them
+    SDL_Surface* digitSurfaces[11]{};
+    SDL_Surface* waveTextSurface = nullptr;
+    SDL_Surface* enemiesLeftTextSurface = nullptr;
+    SDL_Surface* waveStartingTextSurface = nullptr;
+    bool decoded = false;
+
+    // Drop whatever is still decoded, after a failure or when never uploaded
+    void freeSurfaces();
+
     SDL_Texture* digitTextures[11]{};
     int digitW = 0;
     int digitH = 0;
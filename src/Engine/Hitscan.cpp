@@ -0,0 +1,228 @@
+#include "Hitscan.h"
+#include "EnemyManager.h"
+#include <algorithm>
+#include <cmath>
+
+bool Hitscan::traceWall(const Map& map, float x, float y, float z,
+                        float dirX, float dirY, float maxRange,
+                        RayHit& outHit, float& outDistance)
+{
+    int mapX = int(x);
+    int mapY = int(y);
+
+    float deltaDistX = (dirX != 0) ? std::abs(1.0f / dirX) : 1e30f;
+    float deltaDistY = (dirY != 0) ? std::abs(1.0f / dirY) : 1e30f;
+
+    int stepX = (dirX < 0) ? -1 : 1;
+    int stepY = (dirY < 0) ? -1 : 1;
+
+    float sideDistX = (dirX < 0) ? (x - mapX) * deltaDistX : (mapX + 1.0f - x) * deltaDistX;
+    float sideDistY = (dirY < 0) ? (y - mapY) * deltaDistY : (mapY + 1.0f - y) * deltaDistY;
+
+    bool verticalHit = false;
+    float distance = 0.0f;
+
+    const int CHUNK_MASK = Map::CHUNK_SIZE - 1;
+
+    for (;;) {
+        if (map.chunkTopFast(mapX, mapY) <= z) {
+            // Nothing in this chunk reaches the shot, jump straight to the
+            // first tile past it. Tile crossings needed to leave on each axis:
+            int crossX = (stepX > 0) ? Map::CHUNK_SIZE - (mapX & CHUNK_MASK) : (mapX & CHUNK_MASK) + 1;
+            int crossY = (stepY > 0) ? Map::CHUNK_SIZE - (mapY & CHUNK_MASK) : (mapY & CHUNK_MASK) + 1;
+
+            float exitX = sideDistX + (crossX - 1) * deltaDistX;
+            float exitY = sideDistY + (crossY - 1) * deltaDistY;
+
+            // Same tie-break as the single step below, Y wins ties
+            if (exitX < exitY) {
+                int alongY = (sideDistY <= exitX) ? std::min(int((exitX - sideDistY) / deltaDistY) + 1, crossY - 1) : 0;
+                mapY += alongY * stepY;
+                sideDistY += alongY * deltaDistY;
+
+                distance = exitX;
+                mapX += crossX * stepX;
+                sideDistX = exitX + deltaDistX;
+                verticalHit = true;
+            } else {
+                int alongX = (sideDistX < exitY) ? std::min(int(std::ceil((exitY - sideDistX) / deltaDistX)), crossX - 1) : 0;
+                mapX += alongX * stepX;
+                sideDistX += alongX * deltaDistX;
+
+                distance = exitY;
+                mapY += crossY * stepY;
+                sideDistY = exitY + deltaDistY;
+                verticalHit = false;
+            }
+        }
+        else if (sideDistX < sideDistY) {
+            distance = sideDistX;
+            sideDistX += deltaDistX;
+            mapX += stepX;
+            verticalHit = true;
+        } else {
+            distance = sideDistY;
+            sideDistY += deltaDistY;
+            mapY += stepY;
+            verticalHit = false;
+        }
+
+        if (distance >= maxRange)
+            return false;
+
+        if (!map.inBounds(mapX, mapY))
+            return false;
+
+        // Live height, lowered walls and steps below the shot let it pass
+        if (map.heightFast(mapX, mapY) > z)
+            break;
+    }
+
+    float hitX = x + dirX * distance;
+    float hitY = y + dirY * distance;
+
+    outHit.tileX = mapX;
+    outHit.tileY = mapY;
+    outHit.hitX = hitX;
+    outHit.hitY = hitY;
+    outHit.vertical = verticalHit;
+    if (verticalHit) {
+        outHit.hitFraction = hitY - mapY;  // normal
+        if (dirX > 0) outHit.hitFraction = 1.0f - outHit.hitFraction; // flip if coming from right
+    } else {
+        outHit.hitFraction = hitX - mapX;  // normal
+        if (dirY > 0) outHit.hitFraction = 1.0f - outHit.hitFraction; // flip if coming from bottom
+    }
+    outHit.hitHeight = z;
+
+    outDistance = distance;
+    return true;
+}
+
+HitscanHit Hitscan::cast(const Map& map, const EnemyManager& enemies,
+                         float x, float y, float z,
+                         const HitscanRay& ray, float maxRange)
+{
+    HitscanHit hit;
+    castBatch(map, enemies, x, y, z, &ray, 1, maxRange, &hit);
+    return hit;
+}
+
+void Hitscan::castBatch(const Map& map, const EnemyManager& enemies,
+                        float x, float y, float z,
+                        const HitscanRay* rays, int count, float maxRange,
+                        HitscanHit* out)
+{
+    if (count <= 0)
+        return;
+
+    if (count > MAX_BATCH) {
+        for (int first = 0; first < count; first += MAX_BATCH)
+            castBatch(map, enemies, x, y, z, rays + first, std::min(MAX_BATCH, count - first), maxRange, out + first);
+        return;
+    }
+
+    // Walls first, they bound how far each ray (and the corridor) reaches
+    float limit[MAX_BATCH];
+    float farthest = 0.0f;
+
+    float centerX = 0.0f;
+    float centerY = 0.0f;
+    float maxWidth = 0.0f;
+
+    for (int r = 0; r < count; r++) {
+        out[r] = HitscanHit();
+        limit[r] = maxRange;
+
+        float wallDist;
+        if (traceWall(map, x, y, z, rays[r].dirX, rays[r].dirY, maxRange, out[r].wall, wallDist)) {
+            out[r].type = HitscanHit::Type::Wall;
+            out[r].distance = wallDist;
+            limit[r] = wallDist;
+        }
+
+        farthest = std::max(farthest, limit[r]);
+        centerX += rays[r].dirX;
+        centerY += rays[r].dirY;
+        maxWidth = std::max(maxWidth, rays[r].hitWidth);
+    }
+
+    float len = std::sqrt(centerX*centerX + centerY*centerY);
+    if (len <= 0.0f)
+        return;
+    centerX /= len;
+    centerY /= len;
+
+    // How fast the fan spreads away from its center line
+    float spread = 0.0f;
+    for (int r = 0; r < count; r++)
+        spread = std::max(spread, std::abs(rays[r].dirX * centerY - rays[r].dirY * centerX));
+
+    // One DDA walk down the center, collecting enemies from the tiles the fan
+    // can reach. Neighbouring lookups overlap, the stamps keep each slot once.
+    EnemyManager::QueryScratch& gathered = enemies.query;
+    gathered.begin();
+
+    int mapX = int(x);
+    int mapY = int(y);
+
+    float deltaDistX = (centerX != 0) ? std::abs(1.0f / centerX) : 1e30f;
+    float deltaDistY = (centerY != 0) ? std::abs(1.0f / centerY) : 1e30f;
+
+    int stepX = (centerX < 0) ? -1 : 1;
+    int stepY = (centerY < 0) ? -1 : 1;
+
+    float sideDistX = (centerX < 0) ? (x - mapX) * deltaDistX : (mapX + 1.0f - x) * deltaDistX;
+    float sideDistY = (centerY < 0) ? (y - mapY) * deltaDistY : (mapY + 1.0f - y) * deltaDistY;
+
+    float enter = 0.0f;
+    while (enter <= farthest) {
+        float exit = std::min(sideDistX, sideDistY);
+        float radius = 0.75f + maxWidth + exit * spread;
+
+        enemies.grid.forEachNear(mapX + 0.5f, mapY + 0.5f, radius, [&](int slot) {
+            gathered.add(slot);
+        });
+
+        if (sideDistX < sideDistY) {
+            sideDistX += deltaDistX;
+            mapX += stepX;
+        } else {
+            sideDistY += deltaDistY;
+            mapY += stepY;
+        }
+        enter = exit;
+    }
+
+    const EnemyHot& hot = enemies.hot;
+
+    for (int r = 0; r < count; r++) {
+        const HitscanRay& ray = rays[r];
+        float best = limit[r];
+        int bestSlot = -1;
+
+        for (int slot : gathered.slots) {
+            // Too much vertical separation between the shot and the body
+            if (std::abs(z - (hot.z[slot] + 0.5f)) > 0.5f) continue;
+
+            float dx = hot.x[slot] - x;
+            float dy = hot.y[slot] - y;
+
+            float along = dx * ray.dirX + dy * ray.dirY;
+            if (along <= 0.0f || along >= best) continue;
+
+            // World-space perpendicular distance from shot line
+            float perpDist = std::abs(dy * ray.dirX - dx * ray.dirY);
+            if (perpDist >= ray.hitWidth) continue;
+
+            best = along;
+            bestSlot = slot;
+        }
+
+        if (bestSlot >= 0) {
+            out[r].type = HitscanHit::Type::Enemy;
+            out[r].enemySlot = bestSlot;
+            out[r].distance = best;
+        }
+    }
+}
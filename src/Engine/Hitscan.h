@@ -0,0 +1,44 @@
+#pragma once
+#include "Map.h"
+
+class EnemyManager;
+
+struct HitscanRay {
+    float dirX, dirY;  // unit direction
+    float hitWidth;    // how far off the line an enemy still counts
+};
+
+struct HitscanHit {
+    enum class Type { None, Enemy, Wall };
+
+    Type type = Type::None;
+    int enemySlot = -1;   // Enemy hits
+    float distance = 0.0f;
+    RayHit wall{};        // Wall hits
+};
+
+// Instant-hit shots against the live map and the enemy grid. Each ray walks
+// the tiles with DDA, stops at the first wall taller than the shot, and
+// returns whichever of that wall or an enemy is nearest.
+class Hitscan {
+public:
+    // Rays per castBatch pass, larger batches are split
+    static constexpr int MAX_BATCH = 16;
+
+    static HitscanHit cast(const Map& map, const EnemyManager& enemies,
+                           float x, float y, float z,
+                           const HitscanRay& ray, float maxRange);
+
+    // Fan of rays from one origin (shotgun pellets). Enemy candidates are
+    // gathered along a single corridor covering the whole fan, so extra
+    // rays cost little more than their wall walk.
+    static void castBatch(const Map& map, const EnemyManager& enemies,
+                          float x, float y, float z,
+                          const HitscanRay* rays, int count, float maxRange,
+                          HitscanHit* out);
+
+private:
+    static bool traceWall(const Map& map, float x, float y, float z,
+                          float dirX, float dirY, float maxRange,
+                          RayHit& outHit, float& outDistance);
+};
@@ -0,0 +1,252 @@
+#include "LevelFile.h"
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <type_traits>
+
+namespace {
+    const char LEVEL_MAGIC[4] = { 'F', 'S', 'L', 'V' };
+    const uint32_t LEVEL_VERSION = 2;
+
+    struct LevelHeader {
+        char magic[4];
+        uint32_t version;
+        int32_t width;
+        int32_t height;
+        uint32_t segmentCount;
+        uint32_t bspNodeCount;
+        uint32_t bspSegmentCount;
+        uint32_t spawnCount;
+        uint32_t groupCount;
+        uint32_t reserved;
+        uint64_t sourceHash;
+    };
+
+    // Arrays are written as raw memory, make sure that stays meaningful
+    static_assert(std::is_trivially_copyable_v<GridSegment> && sizeof(GridSegment) == 36);
+    static_assert(std::is_trivially_copyable_v<FlatBSPNode> && sizeof(FlatBSPNode) == 32);
+    static_assert(sizeof(LevelCell) == 12);
+
+    struct Writer {
+        std::vector<char> bytes;
+
+        void put(const void* data, std::size_t size) {
+            const char* p = static_cast<const char*>(data);
+            bytes.insert(bytes.end(), p, p + size);
+        }
+
+        template <typename T>
+        void putArray(const std::vector<T>& v) {
+            put(v.data(), v.size() * sizeof(T));
+        }
+
+        void putTiles(const std::vector<std::pair<int,int>>& tiles) {
+            for (const auto& [x, y] : tiles) {
+                int32_t xy[2] = { x, y };
+                put(xy, sizeof(xy));
+            }
+        }
+    };
+
+    struct Reader {
+        const char* pos;
+        const char* end;
+
+        bool get(void* data, std::size_t size) {
+            if ((std::size_t)(end - pos) < size)
+                return false;
+
+            std::memcpy(data, pos, size);
+            pos += size;
+            return true;
+        }
+
+        template <typename T>
+        bool getArray(std::vector<T>& v, std::size_t count) {
+            if ((std::size_t)(end - pos) / sizeof(T) < count)
+                return false;
+
+            v.resize(count);
+            return get(v.data(), count * sizeof(T));
+        }
+
+        bool getTiles(std::vector<std::pair<int,int>>& tiles, std::size_t count) {
+            if ((std::size_t)(end - pos) / (2 * sizeof(int32_t)) < count)
+                return false;
+
+            tiles.resize(count);
+            for (auto& [x, y] : tiles) {
+                int32_t xy[2];
+                get(xy, sizeof(xy));
+                x = xy[0];
+                y = xy[1];
+            }
+            return true;
+        }
+    };
+}
+
+bool hashLevelSource(const std::string& path, uint64_t& hash) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+        return false;
+
+    hash = 0xCBF29CE484222325ull;
+    char buffer[4096];
+    while (file.read(buffer, sizeof(buffer)) || file.gcount() > 0) {
+        for (std::streamsize i = 0; i < file.gcount(); i++) {
+            hash ^= (uint8_t)buffer[i];
+            hash *= 0x100000001B3ull;
+        }
+    }
+    return true;
+}
+
+void compileLevel(const Map& map, LevelData& out) {
+    out = LevelData();
+    out.width = map.width;
+    out.height = map.height;
+
+    out.cells.reserve((std::size_t)map.width * map.height);
+    for (int y = 0; y < map.height; y++) {
+        for (int x = 0; x < map.width; x++) {
+            const Map::Cell c = map.get(x, y);
+            out.cells.push_back({ (uint8_t)c.type, map.flagsAt(x, y), 0, c.height, c.cHeight });
+        }
+    }
+
+    out.segments = buildSegmentsFromGrid(map);
+
+    std::unique_ptr<BSPNode> root = buildBSP(out.segments);
+    flattenBSP(root.get(), out.bspNodes, out.bspSegments);
+
+    // Column-major, the order enemies have always picked spawn points in
+    for (int x = 0; x < map.width; x++) {
+        for (int y = 0; y < map.height; y++) {
+            if (map.typeAt(x, y) == Map::TileType::Spawn)
+                out.spawnPoints.push_back({ x, y });
+        }
+    }
+
+    out.groups = map.getTileGroups();
+}
+
+bool writeLevelFile(const std::string& path, const LevelData& level) {
+    LevelHeader header;
+    std::memcpy(header.magic, LEVEL_MAGIC, sizeof(header.magic));
+    header.version = LEVEL_VERSION;
+    header.width = level.width;
+    header.height = level.height;
+    header.segmentCount = (uint32_t)level.segments.size();
+    header.bspNodeCount = (uint32_t)level.bspNodes.size();
+    header.bspSegmentCount = (uint32_t)level.bspSegments.size();
+    header.spawnCount = (uint32_t)level.spawnPoints.size();
+    header.groupCount = (uint32_t)level.groups.size();
+    header.reserved = 0;
+    header.sourceHash = level.sourceHash;
+
+    Writer w;
+    w.put(&header, sizeof(header));
+    w.putArray(level.cells);
+    w.putArray(level.segments);
+    w.putArray(level.bspNodes);
+    w.putArray(level.bspSegments);
+    w.putTiles(level.spawnPoints);
+
+    for (const Map::TileGroup& g : level.groups) {
+        uint32_t nameLength = (uint32_t)g.name.size();
+        uint32_t tileCount = (uint32_t)g.tiles.size();
+        w.put(&nameLength, sizeof(nameLength));
+        w.put(g.name.data(), nameLength);
+        w.put(&tileCount, sizeof(tileCount));
+        w.putTiles(g.tiles);
+    }
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file || !file.write(w.bytes.data(), (std::streamsize)w.bytes.size())) {
+        std::cerr << "Failed to write level: " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool readLevelFile(const std::string& path, LevelData& level) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file)
+        return false;
+
+    std::vector<char> bytes((std::size_t)file.tellg());
+    file.seekg(0);
+    if (!file.read(bytes.data(), (std::streamsize)bytes.size())) {
+        std::cerr << "Failed to read level: " << path << std::endl;
+        return false;
+    }
+
+    Reader r{ bytes.data(), bytes.data() + bytes.size() };
+
+    LevelHeader header;
+    if (!r.get(&header, sizeof(header)) ||
+        std::memcmp(header.magic, LEVEL_MAGIC, sizeof(header.magic)) != 0) {
+        std::cerr << path << ": not a baked level" << std::endl;
+        return false;
+    }
+
+    if (header.version != LEVEL_VERSION) {
+        std::cerr << path << ": level version " << header.version
+                  << ", expected " << LEVEL_VERSION << std::endl;
+        return false;
+    }
+
+    if (header.width <= 0 || header.height <= 0) {
+        std::cerr << path << ": bad level size" << std::endl;
+        return false;
+    }
+
+    level = LevelData();
+    level.width = header.width;
+    level.height = header.height;
+    level.sourceHash = header.sourceHash;
+
+    bool ok = r.getArray(level.cells, (std::size_t)header.width * header.height) &&
+              r.getArray(level.segments, header.segmentCount) &&
+              r.getArray(level.bspNodes, header.bspNodeCount) &&
+              r.getArray(level.bspSegments, header.bspSegmentCount) &&
+              r.getTiles(level.spawnPoints, header.spawnCount);
+
+    for (uint32_t i = 0; ok && i < header.groupCount; i++) {
+        Map::TileGroup g;
+        uint32_t nameLength = 0, tileCount = 0;
+
+        ok = r.get(&nameLength, sizeof(nameLength)) && (std::size_t)(r.end - r.pos) >= nameLength;
+        if (!ok)
+            break;
+
+        g.name.assign(r.pos, nameLength);
+        r.pos += nameLength;
+
+        ok = r.get(&tileCount, sizeof(tileCount)) && r.getTiles(g.tiles, tileCount);
+        level.groups.push_back(std::move(g));
+    }
+
+    if (!ok) {
+        std::cerr << path << ": truncated level" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void applyLevel(const LevelData& level, Map& map) {
+    std::vector<Map::Cell> cells;
+    cells.reserve(level.cells.size());
+
+    for (const LevelCell& c : level.cells) {
+        Map::Cell cell{ (Map::TileType)c.type, c.height, c.cHeight };
+        cell.isExit    = (c.flags & Map::FLAG_EXIT) != 0;
+        cell.isEscape  = (c.flags & Map::FLAG_ESCAPE) != 0;
+        cell.isSliding = (c.flags & Map::FLAG_SLIDING) != 0;
+        cell.isLava    = (c.flags & Map::FLAG_LAVA) != 0;
+        cells.push_back(cell);
+    }
+
+    map.loadCells(level.width, level.height, cells, level.groups);
+}
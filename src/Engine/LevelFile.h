@@ -0,0 +1,49 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+#include "BSP.h"
+#include "Map.h"
+
+// Baked level: everything the game needs from a .lvl source with the
+// geometry work (segment merging, BSP build, spawn scan) already done.
+// Tools/LevelCompiler writes these at build time, GameSession reads one
+// back with a single file read.
+
+// Cell as stored on disk, fixed layout so the file has no padding bytes
+struct LevelCell {
+    uint8_t type;
+    uint8_t flags;     // Map::CellFlags bits
+    uint16_t reserved;
+    float height;
+    float cHeight;
+};
+
+struct LevelData {
+    int width = 0;
+    int height = 0;
+
+    std::vector<LevelCell> cells;          // row-major, width * height
+    std::vector<GridSegment> segments;     // merged wall segments
+    std::vector<FlatBSPNode> bspNodes;     // root at index 0
+    std::vector<GridSegment> bspSegments;  // on-plane ranges the nodes point into
+    std::vector<std::pair<int,int>> spawnPoints;
+    std::vector<Map::TileGroup> groups;    // sliding walls and doors by name
+
+    uint64_t sourceHash = 0;               // hashLevelSource() of the .lvl it was baked from
+};
+
+// FNV-1a over the source file's bytes, false if it can't be read
+bool hashLevelSource(const std::string& path, uint64_t& hash);
+
+// Run the geometry pipeline over a loaded map
+void compileLevel(const Map& map, LevelData& out);
+
+bool writeLevelFile(const std::string& path, const LevelData& level);
+
+// False if the file is missing, truncated or from another format version
+bool readLevelFile(const std::string& path, LevelData& level);
+
+// Hand the baked cells and groups to the map, rebuilds line of sight
+void applyLevel(const LevelData& level, Map& map);
@@ -0,0 +1,239 @@
+#include "Map.h"
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+Map::Map() {
+    reset(FALLBACK_SIZE, FALLBACK_SIZE);
+
+    std::fill(std::begin(solidChunk.type), std::end(solidChunk.type), (uint8_t)TileType::Wall);
+    std::fill(std::begin(solidChunk.flags), std::end(solidChunk.flags), 0);
+    std::fill(std::begin(solidChunk.height), std::end(solidChunk.height), toFixed(1.0f));
+    std::fill(std::begin(solidChunk.cHeight), std::end(solidChunk.cHeight), toFixed(1.0f));
+}
+
+void Map::reset(int w, int h) {
+    width = std::max(1, w);
+    height = std::max(1, h);
+
+    chunksX = (width + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    chunksY = (height + CHUNK_SIZE - 1) / CHUNK_SIZE;
+
+    // The border ring always stays on the shared solid chunk
+    dirStride = chunksX + 2 * BORDER / CHUNK_SIZE;
+    ownedChunks.clear();
+    chunkDir.assign(dirStride * (chunksY + 2 * BORDER / CHUNK_SIZE), &solidChunk);
+    chunkTop.assign(chunkDir.size(), toFixed(1.0f));
+
+    baseHeight.assign(width * height, 1.0f);
+    groups.clear();
+    walkVersion++;
+}
+
+void Map::setCell(int x, int y, const Cell& cell) {
+    x = clampX(x);
+    y = clampY(y);
+
+    Chunk& c = writableChunk(x, y);
+    int i = cellIndex(x, y);
+
+    int16_t old = c.height[i];
+    c.type[i] = (uint8_t)cell.type;
+    c.height[i] = toFixed(cell.height);
+    updateChunkTop(slotOf(x, y), old, c.height[i]);
+    c.cHeight[i] = toFixed(cell.cHeight);
+    c.flags[i] = (cell.isExit    ? FLAG_EXIT : 0) |
+                 (cell.isEscape  ? FLAG_ESCAPE : 0) |
+                 (cell.isSliding ? FLAG_SLIDING : 0) |
+                 (cell.isLava    ? FLAG_LAVA : 0);
+}
+
+void Map::materialize(int chunkIndex) {
+    auto chunk = std::make_unique<Chunk>(solidChunk);
+    chunkDir[chunkIndex] = chunk.get();
+    ownedChunks.push_back(std::move(chunk));
+}
+
+namespace {
+    // Reads "x0 y0 x1 y1" and clips it to the map, false if malformed
+    bool readRect(std::istringstream& in, const Map& map, int& x0, int& y0, int& x1, int& y1) {
+        if (!(in >> x0 >> y0 >> x1 >> y1))
+            return false;
+
+        if (x0 > x1) std::swap(x0, x1);
+        if (y0 > y1) std::swap(y0, y1);
+
+        x0 = std::max(x0, 0);
+        y0 = std::max(y0, 0);
+        x1 = std::min(x1, map.width - 1);
+        y1 = std::min(y1, map.height - 1);
+        return true;
+    }
+}
+
+void Map::loadCells(int w, int h, const std::vector<Cell>& cells, std::vector<TileGroup> tileGroups) {
+    reset(w, h);
+
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            const Cell& c = cells[y * width + x];
+
+            // Plain solid wall is what reset() left, keep sharing the solid chunk
+            bool solid = c.type == TileType::Wall && c.height == 1.0f && c.cHeight == 1.0f &&
+                         !c.isExit && !c.isEscape && !c.isSliding && !c.isLava;
+            if (!solid)
+                setCell(x, y, c);
+        }
+    }
+
+    groups = std::move(tileGroups);
+    finishLoad(true);
+}
+
+const std::vector<std::pair<int,int>>& Map::getTileGroup(const std::string& name) const {
+    static const std::vector<std::pair<int,int>> none;
+
+    for (const TileGroup& g : groups) {
+        if (g.name == name)
+            return g.tiles;
+    }
+
+    std::cerr << "Level has no tile group '" << name << "'" << std::endl;
+    return none;
+}
+
+void Map::finishLoad(bool buildVisibility) {
+    // Remember authored heights so a new run can restore them
+    for (int y = 0; y < height; y++)
+        for (int x = 0; x < width; x++)
+            baseHeight[y * width + x] = heightFast(x, y);
+
+    walkVersion++;
+    if (buildVisibility)
+        visibility.build(*this);
+}
+
+bool Map::loadFromFile(const std::string& path, bool buildVisibility) {
+    std::ifstream file(path);
+    if (!file) {
+        std::cerr << "Failed to open level: " << path << std::endl;
+        reset(FALLBACK_SIZE, FALLBACK_SIZE);
+        visibility.build(*this);
+        return false;
+    }
+
+    auto fail = [&](int lineNo, const std::string& why) {
+        std::cerr << path << ":" << lineNo << ": " << why << std::endl;
+        reset(FALLBACK_SIZE, FALLBACK_SIZE);
+        visibility.build(*this);
+        return false;
+    };
+
+    bool sized = false;
+    int rowsLeft = 0;
+    int row = 0;
+
+    std::string line;
+    int lineNo = 0;
+
+    while (std::getline(file, line)) {
+        lineNo++;
+
+        if (!line.empty() && line.back() == '\r')
+            line.pop_back();
+
+        // Tile rows, one character per tile
+        if (rowsLeft > 0) {
+            if ((int)line.size() < width)
+                return fail(lineNo, "tile row shorter than the map width");
+
+            for (int x = 0; x < width; x++) {
+                char t = line[x];
+                if (t == '1')
+                    continue; // already solid wall
+
+                if (t != '0' && t != '2')
+                    return fail(lineNo, std::string("unknown tile '") + t + "'");
+
+                setCell(x, row, { t == '2' ? TileType::Spawn : TileType::Empty, 0.0f, 1.0f });
+            }
+
+            row++;
+            rowsLeft--;
+            continue;
+        }
+
+        std::size_t hash = line.find('#');
+        if (hash != std::string::npos)
+            line.erase(hash);
+
+        std::istringstream in(line);
+        std::string cmd;
+        if (!(in >> cmd))
+            continue;
+
+        if (cmd == "size") {
+            int w = 0, h = 0;
+            if (!(in >> w >> h) || w <= 0 || h <= 0)
+                return fail(lineNo, "bad size");
+
+            reset(w, h);
+            sized = true;
+            continue;
+        }
+
+        if (!sized)
+            return fail(lineNo, "'size' must come first");
+
+        if (cmd == "tiles") {
+            rowsLeft = height;
+            row = 0;
+            continue;
+        }
+
+        if (cmd == "group") {
+            TileGroup group;
+            int x0, y0, x1, y1;
+            if (!(in >> group.name) || !readRect(in, *this, x0, y0, x1, y1))
+                return fail(lineNo, "expected a name and x0 y0 x1 y1 after 'group'");
+
+            for (int x = x0; x <= x1; x++)
+                for (int y = y0; y <= y1; y++)
+                    group.tiles.push_back({ x, y });
+
+            groups.push_back(std::move(group));
+            continue;
+        }
+
+        if (cmd != "height" && cmd != "sliding" && cmd != "exit" && cmd != "escape" && cmd != "lava")
+            return fail(lineNo, "unknown command '" + cmd + "'");
+
+        int x0, y0, x1, y1;
+        if (!readRect(in, *this, x0, y0, x1, y1))
+            return fail(lineNo, "expected x0 y0 x1 y1 after '" + cmd + "'");
+
+        float h = 0.0f;
+        if (cmd == "height" && !(in >> h))
+            return fail(lineNo, "expected a height");
+
+        for (int y = y0; y <= y1; y++) {
+            for (int x = x0; x <= x1; x++) {
+                Cell c = get(x, y);
+
+                if (cmd == "height")       c.height = h;
+                else if (cmd == "sliding") c.isSliding = true;
+                else if (cmd == "exit")    c.isExit = true;
+                else if (cmd == "escape")  c.isEscape = true;
+                else if (cmd == "lava")    c.isLava = true;
+
+                setCell(x, y, c);
+            }
+        }
+    }
+
+    if (!sized || rowsLeft > 0)
+        return fail(lineNo, "missing size or tile rows");
+
+    finishLoad(buildVisibility);
+    return true;
+}
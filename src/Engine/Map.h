@@ -2,6 +2,14 @@
 #define MAP_H
 
 #include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include "Visibility.h"
 
 struct RayHit {
     int tileX;
@@ -15,8 +23,20 @@ struct RayHit {
 
 class Map {
 public:
-    static const int SIZE = 30;
-    static const int CHUNK_SIZE = 10;
+    // Cells are stored in square chunks of CHUNK_SIZE tiles
+    static const int CHUNK_SHIFT = 4;
+    static const int CHUNK_SIZE = 1 << CHUNK_SHIFT;
+    static const int CHUNK_AREA = CHUNK_SIZE * CHUNK_SIZE;
+
+    // Ring of shared solid chunks around the map. getFast() can read up to
+    // BORDER tiles out of bounds and sees sentinel walls there.
+    static const int BORDER = CHUNK_SIZE;
+
+    // Used when a level fails to load so nothing downstream sees a 0x0 map
+    static const int FALLBACK_SIZE = 30;
+
+    // Tallest wall an enemy can step onto
+    static constexpr float STEP_HEIGHT = 0.25f;
 
     // -----------------------------
     // Tile type for readability
@@ -27,8 +47,20 @@ public:
         Spawn = 2
     };
 
+    // Tile flag bits, one byte per tile in the flag plane
+    enum CellFlags : uint8_t {
+        FLAG_EXIT    = 1 << 0,
+        FLAG_ESCAPE  = 1 << 1,
+        FLAG_SLIDING = 1 << 2,
+        FLAG_LAVA    = 1 << 3
+    };
+
+    // Heights are stored as int16 fixed point, HEIGHT_SCALE steps per world
+    // unit (range about +-32, step ~0.001)
+    static constexpr float HEIGHT_SCALE = 1024.0f;
+
     // -----------------------------
-    // Full cell data structure
+    // Full cell data structure, rebuilt from the planes on demand
     // -----------------------------
     struct Cell {
         TileType type;
@@ -40,311 +72,172 @@ public:
         bool isLava = false; // For lava pit
     };
 
-    // -----------------------------
-    // Editable raw tile map
-    // -----------------------------
-    int rawMap[SIZE][SIZE] = {
-
-        {1,1,1,1,1,1,1,1,1,1,1,1,1,1,1, 1,1,1,1,1,1,1,1,1,1,1,1,1,1,1},
-        {1,1,1,1,1,0,0,0,1,1,1,1,0,0,0, 0,0,0,1,1,1,1,0,0,0,1,1,1,1,1},
-        {1,1,1,1,0,0,0,0,0,0,0,0,0,0,0, 0,0,0,0,0,0,0,0,0,0,0,1,1,1,1},
-        {1,1,1,1,1,0,0,0,1,1,1,1,0,0,0, 0,0,0,1,1,1,1,0,0,0,1,1,1,1,1},
-        {1,1,1,1,1,1,1,1,1,1,1,1,1,1,1, 1,1,1,1,1,1,1,1,1,1,1,1,1,1,1},
-
-        {1,1,1,1,1,1,1,1,1,1,1,1,1,1,1, 1,1,1,1,1,1,1,1,1,1,1,1,1,1,1},
-        {1,1,1,1,1,1,0,0,0,0,0,0,0,0,0, 0,0,0,0,0,0,0,0,0,1,1,1,1,1,1},
-        {1,1,1,0,0,1,0,0,1,1,1,0,0,0,0, 0,0,0,0,1,1,1,0,0,1,0,0,1,1,1},
-        {1,1,1,0,0,1,0,0,1,1,1,0,2,0,0, 0,0,0,0,1,1,1,0,2,1,0,0,1,1,1},
-        {1,1,1,0,0,1,0,0,1,1,1,0,0,0,0, 0,0,0,0,1,1,1,0,0,1,0,0,1,1,1},
-
-        {1,1,1,1,1,1,0,0,0,0,0,0,0,0,0, 0,0,0,0,0,0,0,0,0,1,1,1,1,1,1},
-        {1,1,1,1,1,1,0,0,0,0,0,0,0,0,0, 0,0,0,0,0,0,0,0,0,1,1,1,1,1,1},
-        {1,1,1,1,1,1,0,0,0,1,0,1,1,1,1, 1,1,1,1,0,1,0,0,0,1,1,1,1,1,1},
-        {1,1,1,1,1,1,0,0,0,0,0,1,0,0,0, 0,0,0,1,0,0,0,0,0,1,1,1,1,1,1},
-        {1,1,1,1,1,1,0,0,0,0,0,1,0,0,0, 0,0,0,1,0,0,0,0,0,1,1,1,1,1,1},
-
-        {1,1,1,1,1,1,0,0,0,0,0,1,0,0,0, 0,0,0,1,0,0,0,0,0,1,1,1,1,1,1},
-        {1,1,1,1,1,1,0,0,0,0,0,1,0,0,0, 0,0,0,1,0,0,0,0,0,1,1,1,1,1,1},
-        {1,1,1,1,1,1,0,0,0,1,0,1,1,1,1, 1,1,1,1,0,1,0,0,0,1,1,1,1,1,1},
-        {1,1,1,1,1,1,0,0,0,0,0,0,0,0,0, 0,0,0,0,0,0,0,0,0,1,1,1,1,1,1},
-        {1,1,1,1,1,1,0,0,0,0,0,0,0,0,0, 0,0,0,0,0,0,0,0,0,1,1,1,1,1,1},
-
-        {1,1,1,0,0,1,0,0,1,1,1,0,0,0,0, 0,0,0,0,1,1,1,0,0,1,0,0,1,1,1},
-        {1,1,1,0,0,1,2,0,1,1,1,0,0,1,0, 0,1,2,0,1,1,1,0,0,1,0,0,1,1,1},
-        {1,1,1,0,0,1,0,0,1,1,1,0,0,0,0, 0,0,0,0,1,1,1,0,0,1,0,0,1,1,1},
-        {1,1,1,1,1,1,0,0,0,0,0,0,0,0,0, 0,0,0,0,0,0,0,0,0,1,1,1,1,1,1},
-        {1,1,1,1,1,1,1,1,1,1,1,1,1,1,1, 1,1,1,1,1,1,1,1,1,1,1,1,1,1,1},
-
-        {1,1,1,1,1,1,1,1,1,1,1,1,1,0,0, 0,0,1,1,1,1,1,1,1,1,1,1,1,1,1},
-        {1,1,1,1,1,1,1,1,1,1,1,1,1,0,0, 0,0,1,1,1,1,1,1,1,1,1,1,1,1,1},
-        {1,1,1,1,1,1,1,1,1,1,1,1,1,1,0, 0,1,1,1,1,1,1,1,1,1,1,1,1,1,1},
-        {1,1,1,1,1,1,1,1,1,1,1,1,1,1,1, 1,1,1,1,1,1,1,1,1,1,1,1,1,1,1},
-        {1,1,1,1,1,1,1,1,1,1,1,1,1,1,1, 1,1,1,1,1,1,1,1,1,1,1,1,1,1,1}
+    // Planar storage, a scan only pulls in the planes it reads
+    struct Chunk {
+        uint8_t type[CHUNK_AREA];
+        uint8_t flags[CHUNK_AREA];
+        int16_t height[CHUNK_AREA];
+        int16_t cHeight[CHUNK_AREA];
     };
 
-    // -----------------------------
-    // Struct-based map
-    // -----------------------------
-    Cell data[SIZE][SIZE];
+    // Named tile set the wave script animates (sliding walls, doors)
+    struct TileGroup {
+        std::string name;
+        std::vector<std::pair<int,int>> tiles;
+    };
 
-    // -----------------------------
-    // Construct: auto-build struct map
-    // -----------------------------
-    Map() {
-        initializeCells();
-
-        // Top left raised platform 
-        data[7][8].height = 0.5f;
-        data[8][8].height = 0.5f;
-        data[9][8].height = 0.5f;
-        data[7][9].height = 0.5f;
-        data[8][9].height = 0.5f;
-        data[9][9].height = 0.5f;
-        data[7][10].height = 0.5f;  
-        data[8][10].height = 0.5f;
-        data[9][10].height = 0.5f;  
-
-        // Top right raised platform
-        data[7][19].height = 0.5f;
-        data[8][19].height = 0.5f;
-        data[9][19].height = 0.5f;
-        data[7][20].height = 0.5f;
-        data[8][20].height = 0.5f;
-        data[9][20].height = 0.5f;
-        data[7][21].height = 0.5f;
-        data[8][21].height = 0.5f;
-        data[9][21].height = 0.5f;
-
-        // Bottom left raised platform
-        data[20][8].height = 0.5f;
-        data[21][8].height = 0.5f;
-        data[22][8].height = 0.5f;  
-        data[20][9].height = 0.5f;
-        data[21][9].height = 0.5f;  
-        data[22][9].height = 0.5f;
-        data[20][10].height = 0.5f;
-        data[21][10].height = 0.5f;
-        data[22][10].height = 0.5f;  
-
-        // Bottom right raised platform
-        data[20][19].height = 0.5f;
-        data[21][19].height = 0.5f;
-        data[22][19].height = 0.5f;
-        data[20][20].height = 0.5f;
-        data[21][20].height = 0.5f; 
-        data[22][20].height = 0.5f;
-        data[20][21].height = 0.5f; 
-        data[21][21].height = 0.5f;
-        data[22][21].height = 0.5f;         
-
-        // Cover walls
-        data[12][9].height = 0.25f;
-        data[17][9].height = 0.25f;
-        data[12][20].height = 0.25f;
-        data[17][20].height = 0.25f;
-
-        // Pit walls
-        data[12][11].height = -0.25f; 
-        data[12][12].height = -0.25f;
-        data[12][13].height = -0.25f;   
-        data[12][14].height = -0.25f;
-        data[12][15].height = -0.25f;
-        data[12][16].height = -0.25f;
-        data[12][17].height = -0.25f;
-        data[12][18].height = -0.25f;
-        
-        data[13][11].height = -0.25f;
-        data[14][11].height = -0.25f;
-        data[15][11].height = -0.25f;
-        data[16][11].height = -0.25f;
-        
-        data[13][18].height = -0.25f;
-        data[14][18].height = -0.25f;
-        data[15][18].height = -0.25f;
-        data[16][18].height = -0.25f;
-        
-        data[17][11].height = -0.25f;
-        data[17][12].height = -0.25f;
-        data[17][13].height = -0.25f;
-        data[17][14].height = -0.25f;
-        data[17][15].height = -0.25f;
-        data[17][16].height = -0.25f;
-        data[17][17].height = -0.25f;
-        data[17][18].height = -0.25f;
-
-        // Starting room sliding walls
-        data[4][14].isSliding = true;
-        data[5][14].isSliding = true;
-        data[4][15].isSliding = true;
-        data[5][15].isSliding = true;
-
-        // Wave 1 sliding walls
-        data[7][24].isSliding = true;
-        data[8][24].isSliding = true;
-        data[9][24].isSliding = true;
-
-        // Wave 2 sliding walls
-        data[20][24].isSliding = true;
-        data[21][24].isSliding = true;
-        data[22][24].isSliding = true;
-
-        // Wave 3 sliding walls
-        data[7][5].isSliding = true;
-        data[8][5].isSliding = true;
-        data[9][5].isSliding = true;
-
-        // Wave 4 sliding walls
-        data[20][5].isSliding = true;
-        data[21][5].isSliding = true;
-        data[22][5].isSliding = true;
-
-        // Wave 5 sliding walls
-        data[24][14].isSliding = true;
-        data[24][15].isSliding = true;
-
-        // LevelEnd Doors
-        data[28][14].isExit = true;
-        data[28][15].isExit = true;
-
-        // LevelEnd Tiles
-        data[27][14].isEscape = true;
-        data[27][15].isEscape = true;
-
-        // Lava
-        data[12][11].isLava = true;
-        data[12][12].isLava = true;
-        data[12][13].isLava = true;
-        data[12][14].isLava = true;
-        data[12][15].isLava = true;
-        data[12][16].isLava = true;
-        data[12][17].isLava = true;
-        data[12][18].isLava = true;
-        
-        data[13][11].isLava = true; 
-        data[14][11].isLava = true;  
-        data[15][11].isLava = true;
-        data[16][11].isLava = true;
-        
-        data[13][18].isLava = true;
-        data[14][18].isLava = true;
-        data[15][18].isLava = true;
-        data[16][18].isLava = true;
-        
-        data[17][11].isLava = true;
-        data[17][12].isLava = true;
-        data[17][13].isLava = true;
-        data[17][14].isLava = true;
-        data[17][15].isLava = true; 
-        data[17][16].isLava = true; 
-        data[17][17].isLava = true;
-        data[17][18].isLava = true;
+    // Size in tiles, set by the loaded level
+    int width = 0;
+    int height = 0;
+
+    // Size in chunks
+    int chunksX = 0;
+    int chunksY = 0;
+
+    // Tile-to-tile line of sight, kept in sync through setHeight()
+    Visibility visibility;
+
+    // Bumped whenever a tile flips between walkable and blocked
+    unsigned walkVersion = 0;
+
+    Map();
+
+    // The chunk directory points into this object
+    Map(const Map&) = delete;
+    Map& operator=(const Map&) = delete;
+
+    // Load a level source (see Assets/Levels/level1.lvl for the format).
+    // On failure the map is left as solid FALLBACK_SIZE walls. The level
+    // compiler skips the line of sight build, it never queries it.
+    bool loadFromFile(const std::string& path, bool buildVisibility = true);
+
+    // Take already parsed cells (row-major, w * h) and tile groups
+    void loadCells(int w, int h, const std::vector<Cell>& cells, std::vector<TileGroup> tileGroups);
+
+    const std::vector<TileGroup>& getTileGroups() const { return groups; }
+
+    // Tiles of a named group, empty if the level has none by that name
+    const std::vector<std::pair<int,int>>& getTileGroup(const std::string& name) const;
+
+    // Resize to w x h solid walls, every chunk back to the shared solid one
+    void reset(int w, int h);
+
+    // Change a tile height at runtime. Call refreshVisibility() once the
+    // frame's changes are done so line of sight catches up.
+    void setHeight(int x, int y, float h) {
+        x = clampX(x);
+        y = clampY(y);
+
+        int16_t fixed = toFixed(h);
+        if (chunkAt(x, y).height[cellIndex(x, y)] == fixed)
+            return;
+
+        Chunk& c = writableChunk(x, y);
+        int i = cellIndex(x, y);
+        if ((TileType)c.type[i] == TileType::Wall && (c.height[i] > STEP_FIXED) != (fixed > STEP_FIXED))
+            walkVersion++;
+
+        int16_t old = c.height[i];
+        c.height[i] = fixed;
+        updateChunkTop(slotOf(x, y), old, fixed);
+        visibility.markDirty(x, y);
+    }
+
+    // Overwrite every field of a tile. Level loading only, it leaves line
+    // of sight and walkVersion for finishLoad() to bring up to date.
+    void setCell(int x, int y, const Cell& cell);
+
+    // Heights as authored, before any wall animation
+    float baseHeightAt(int x, int y) const {
+        return baseHeight[clampY(y) * width + clampX(x)];
+    }
+
+    // Enemy walkability, same rule as the enemy wall collision
+    bool isWalkable(int x, int y) const {
+        x = clampX(x);
+        y = clampY(y);
+        const Chunk& c = chunkAt(x, y);
+        int i = cellIndex(x, y);
+        return (TileType)c.type[i] != TileType::Wall || c.height[i] <= STEP_FIXED;
     }
 
-    // Convert raw ints to structured Cell data
-    void initializeCells() {
-        for (int y = 0; y < SIZE; y++) {
-            for (int x = 0; x < SIZE; x++) {
+    bool inBounds(int x, int y) const {
+        return x >= 0 && y >= 0 && x < width && y < height;
+    }
+
+    void refreshVisibility() {
+        visibility.refresh(*this);
+    }
+
+    // Undo runtime height changes (sliding walls) for a new run
+    void resetHeights() {
+        for (int y = 0; y < height; y++)
+            for (int x = 0; x < width; x++)
+                setHeight(x, y, baseHeight[y * width + x]);
 
-                int v = rawMap[y][x];
+        refreshVisibility();
+    }
+
+    // Safe accessor, whole cell by value. Prefer the single-plane reads
+    // below in loops that only need one field.
+    inline Cell get(int x, int y) const {
+        return getFast(clampX(x), clampY(y));
+    }
 
-                switch (v) {
-                    case 0:
-                        data[y][x] = {TileType::Empty, 0.0f, 1.0f};
-                        break;
+    // Unchecked accessors for hot loops (collision, DDA, neighbor probes).
+    // Valid for -BORDER <= x < width + BORDER, same for y, tiles outside
+    // the map read as solid wall instead of the clamped edge tile.
+    inline Cell getFast(int x, int y) const {
+        const Chunk& c = chunkAt(x, y);
+        int i = cellIndex(x, y);
+        uint8_t f = c.flags[i];
+
+        Cell cell{ (TileType)c.type[i], fromFixed(c.height[i]), fromFixed(c.cHeight[i]) };
+        cell.isExit    = (f & FLAG_EXIT) != 0;
+        cell.isEscape  = (f & FLAG_ESCAPE) != 0;
+        cell.isSliding = (f & FLAG_SLIDING) != 0;
+        cell.isLava    = (f & FLAG_LAVA) != 0;
+        return cell;
+    }
 
-                    case 1:
-                        data[y][x] = {TileType::Wall, 1.0f, 1.0f}; // default wall and heights
-                        break;
+    inline TileType typeFast(int x, int y) const {
+        return (TileType)chunkAt(x, y).type[cellIndex(x, y)];
+    }
 
-                    case 2:
-                        data[y][x] = {TileType::Spawn, 0.0f, 1.0f};
-                        break;
-                }
-            }
-        }
+    inline float heightFast(int x, int y) const {
+        return fromFixed(chunkAt(x, y).height[cellIndex(x, y)]);
     }
 
-    // Safe accessor (read-only)
-    inline const Cell& get(int x, int y) const {
-        x = std::max(0, std::min(x, SIZE - 1));
-        y = std::max(0, std::min(y, SIZE - 1));
-        return data[y][x];
+    inline uint8_t flagsFast(int x, int y) const {
+        return chunkAt(x, y).flags[cellIndex(x, y)];
     }
 
-    // Safe accessor (mutable)
-    inline Cell& get(int x, int y) {
-        x = std::max(0, std::min(x, SIZE - 1));
-        y = std::max(0, std::min(y, SIZE - 1));
-        return data[y][x];
+    // Tallest tile in the chunk holding (x, y), same range as getFast().
+    // Rays at or above it can cross the whole chunk without reading tiles.
+    inline float chunkTopFast(int x, int y) const {
+        return fromFixed(chunkTop[slotOf(x, y)]);
     }
 
+    // Clamped single-plane reads
+    TileType typeAt(int x, int y) const { return typeFast(clampX(x), clampY(y)); }
+    float heightAt(int x, int y) const { return heightFast(clampX(x), clampY(y)); }
+    uint8_t flagsAt(int x, int y) const { return flagsFast(clampX(x), clampY(y)); }
+
+    // Chunks that own their cells, the rest share one read-only solid chunk
+    int allocatedChunks() const { return (int)ownedChunks.size(); }
+
     // -----------------------------
     // Chunk querying
     // -----------------------------
     inline int getChunkID(int x, int y) const {
-        x = std::max(0, std::min(x, SIZE - 1));
-        y = std::max(0, std::min(y, SIZE - 1));
-        int chunkX = x / CHUNK_SIZE;
-        int chunkY = y / CHUNK_SIZE;
-        return chunkY * 2 + chunkX;
+        return (clampY(y) >> CHUNK_SHIFT) * chunksX + (clampX(x) >> CHUNK_SHIFT);
     }
 
-    // Simple 2D grid DDA
-    bool raycastWall(float x, float y, float dirX, float dirY, float maxRange, RayHit& outHit) const {
-        int mapX = int(x);
-        int mapY = int(y);
-
-        float deltaDistX = (dirX != 0) ? std::abs(1.0f / dirX) : 1e30f;
-        float deltaDistY = (dirY != 0) ? std::abs(1.0f / dirY) : 1e30f;
-
-        int stepX = (dirX < 0) ? -1 : 1;
-        int stepY = (dirY < 0) ? -1 : 1;
-
-        float sideDistX = (dirX < 0) ? (x - mapX) * deltaDistX : (mapX + 1.0f - x) * deltaDistX;
-        float sideDistY = (dirY < 0) ? (y - mapY) * deltaDistY : (mapY + 1.0f - y) * deltaDistY;
-
-        bool hit = false;
-        bool verticalHit = false;
-
-        float distance = 0.0f;
-
-        while (!hit && distance < maxRange) {
-            if (sideDistX < sideDistY) {
-                sideDistX += deltaDistX;
-                mapX += stepX;
-                verticalHit = true;
-                distance = sideDistX - deltaDistX;
-            } else {
-                sideDistY += deltaDistY;
-                mapY += stepY;
-                verticalHit = false;
-                distance = sideDistY - deltaDistY;
-            }
-
-            if (mapY >= 0 && mapY < SIZE && mapX >= 0 && mapX < SIZE && rawMap[mapY][mapX] != 0) {
-                hit = true;
-            }
-        }
-
-        if (!hit) return false;
-
-        // Compute exact intersection position in world space
-        float hitX = x + dirX * distance;
-        float hitY = y + dirY * distance;
-
-        outHit.tileX = mapX;
-        outHit.tileY = mapY;
-        outHit.vertical = verticalHit;
-        if (verticalHit) {
-            outHit.hitFraction = hitY - mapY;  // normal
-            if (dirX > 0) outHit.hitFraction = 1.0f - outHit.hitFraction; // flip if coming from right
-        } else {
-            outHit.hitFraction = hitX - mapX;  // normal
-            if (dirY > 0) outHit.hitFraction = 1.0f - outHit.hitFraction; // flip if coming from bottom
-        }
-        outHit.hitHeight = 0.5f; // just use player height for now
-
-        return true;
+    // Chunks between two chunk ids, 0 = same chunk, 1 = touching (diagonals too)
+    int chunkDistance(int a, int b) const {
+        int dx = std::abs(a % chunksX - b % chunksX);
+        int dy = std::abs(a / chunksX - b / chunksX);
+        return std::max(dx, dy);
     }
 
     // Map.h (inside class Map)
@@ -355,19 +248,76 @@ public:
 
         // If hitFraction is near 0 or 1 along X/Y we can decide
         // A more robust approach: check which neighbor tile is empty to determine orientation
-        int left  = std::max(0, tileX-1);
-        int right = std::min(SIZE-1, tileX+1);
-        int top   = std::max(0, tileY-1);
-        int bottom= std::min(SIZE-1, tileY+1);
+        auto open = [&](int x, int y) { return typeAt(x, y) != TileType::Wall; };
 
         // Check neighbors to see which side has a wall
-        if (rawMap[tileY][left] == 0 || rawMap[tileY][right] == 0) return true;  // vertical wall
-        if (rawMap[top][tileX] == 0 || rawMap[bottom][tileX] == 0) return false; // horizontal wall
+        if (open(tileX - 1, tileY) || open(tileX + 1, tileY)) return true;  // vertical wall
+        if (open(tileX, tileY - 1) || open(tileX, tileY + 1)) return false; // horizontal wall
 
         // fallback: pick based on ray direction
         return std::fabs(rayDirX) > std::fabs(rayDirY);
     }
+
+private:
+    // One entry per chunk, row-major, including the BORDER ring. Points at
+    // an owned chunk or solidChunk.
+    std::vector<Chunk*> chunkDir;
+    int dirStride = 0;
+
+    // Max height per directory slot, kept current by setHeight/setCell
+    std::vector<int16_t> chunkTop;
+    std::vector<std::unique_ptr<Chunk>> ownedChunks;
+    Chunk solidChunk;
+
+    std::vector<float> baseHeight;
+    std::vector<TileGroup> groups;
+
+    int clampX(int x) const { return std::max(0, std::min(x, width - 1)); }
+    int clampY(int y) const { return std::max(0, std::min(y, height - 1)); }
+
+    static constexpr int16_t STEP_FIXED = (int16_t)(STEP_HEIGHT * HEIGHT_SCALE);
+
+    static int16_t toFixed(float h) {
+        float v = std::round(h * HEIGHT_SCALE);
+        return (int16_t)std::max(-32768.0f, std::min(v, 32767.0f));
+    }
+
+    static float fromFixed(int16_t v) { return v * (1.0f / HEIGHT_SCALE); }
+
+    // Directory slot for a tile, x and y may be up to BORDER out of range
+    int slotOf(int x, int y) const {
+        return ((y + BORDER) >> CHUNK_SHIFT) * dirStride + ((x + BORDER) >> CHUNK_SHIFT);
+    }
+
+    const Chunk& chunkAt(int x, int y) const {
+        return *chunkDir[slotOf(x, y)];
+    }
+
+    static int cellIndex(int x, int y) {
+        return ((y & (CHUNK_SIZE - 1)) << CHUNK_SHIFT) | (x & (CHUNK_SIZE - 1));
+    }
+
+    // Chunk for an in-bounds tile, a shared solid chunk gets its own copy first
+    Chunk& writableChunk(int x, int y) {
+        int c = slotOf(x, y);
+        if (chunkDir[c] == &solidChunk)
+            materialize(c);
+        return *chunkDir[c];
+    }
+
+    void materialize(int chunkIndex);
+
+    // Raise the slot's top, or rescan it when its tallest tile came down
+    void updateChunkTop(int slot, int16_t oldHeight, int16_t newHeight) {
+        int16_t& top = chunkTop[slot];
+        if (newHeight >= top)
+            top = newHeight;
+        else if (oldHeight == top)
+            top = *std::max_element(std::begin(chunkDir[slot]->height), std::end(chunkDir[slot]->height));
+    }
+
+    // Authored heights, walk version and line of sight after a load
+    void finishLoad(bool buildVisibility);
 };
 
 #endif
-
@@ -6,7 +6,7 @@
 
 // Helper: check if neighbor is a wall
 static inline bool isWall(const Map& map, int x, int y) {
-    if (x < 0 || y < 0 || x >= Map::SIZE || y >= Map::SIZE) return false;
+    if (!map.inBounds(x, y)) return false;
     return map.get(x,y).type == Map::TileType::Wall;
 }
 
@@ -15,8 +15,8 @@ std::vector<GridSegment> buildSegmentsFromGrid(const Map& map)
     std::vector<GridSegment> edges;
 
     // For each tile that is a wall, produce edges where neighbor is not a wall.
-    for (int y = 0; y < Map::SIZE; ++y) {
-        for (int x = 0; x < Map::SIZE; ++x) {
+    for (int y = 0; y < map.height; ++y) {
+        for (int x = 0; x < map.width; ++x) {
             const auto& cell = map.get(x, y);
 
             const float h = map.get(x, y).height;
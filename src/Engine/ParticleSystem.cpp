@@ -0,0 +1,290 @@
+#include "ParticleSystem.h"
+#include "Player.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    // How each preset looks and moves. Ranges are picked uniformly per particle.
+    struct EffectStyle {
+        uint32_t color;
+        ParticleBlend blend;
+        float sizeMin, sizeMax;
+        float lifeMin, lifeMax;
+        float speedMin, speedMax;   // along the floor
+        float riseMin, riseMax;     // initial upward speed
+        float arc;                  // half angle around the spray direction
+        float gravity;
+        float drag;
+    };
+
+    const EffectStyle& styleOf(ParticleEffect effect) {
+        static const EffectStyle blood  = { 0xFF8A0C0C, ParticleBlend::Alpha,    0.04f, 0.07f, 0.4f, 0.8f, 0.6f, 1.6f,  0.5f, 1.5f, 0.8f,  6.0f, 0.5f };
+        static const EffectStyle sparks = { 0xFFFFD060, ParticleBlend::Additive, 0.02f, 0.03f, 0.15f, 0.35f, 1.5f, 3.0f, -0.5f, 1.5f, 1.2f, 5.0f, 1.0f };
+        static const EffectStyle smoke  = { 0x70A0A0A0, ParticleBlend::Alpha,    0.08f, 0.14f, 0.6f, 1.2f, 0.1f, 0.3f,  0.15f, 0.35f, 0.6f, -0.1f, 2.0f };
+        static const EffectStyle ember  = { 0xFFFF7020, ParticleBlend::Additive, 0.02f, 0.04f, 1.0f, 2.0f, 0.05f, 0.2f, 0.3f, 0.7f, 3.2f, -0.2f, 0.5f };
+
+        switch (effect) {
+            case ParticleEffect::Blood: return blood;
+            case ParticleEffect::Sparks: return sparks;
+            case ParticleEffect::Smoke: return smoke;
+            default: return ember;
+        }
+    }
+}
+
+ParticleSystem::ParticleSystem() {
+    x.resize(CAPACITY);
+    y.resize(CAPACITY);
+    z.resize(CAPACITY);
+    prevX.resize(CAPACITY);
+    prevY.resize(CAPACITY);
+    prevZ.resize(CAPACITY);
+    velX.resize(CAPACITY);
+    velY.resize(CAPACITY);
+    velZ.resize(CAPACITY);
+    life.resize(CAPACITY);
+    invLife.resize(CAPACITY);
+    size.resize(CAPACITY);
+    gravity.resize(CAPACITY);
+    drag.resize(CAPACITY);
+    color.resize(CAPACITY);
+    blend.resize(CAPACITY);
+}
+
+float ParticleSystem::random() {
+    // xorshift32, looks only, so one stream for everything is fine
+    rngState ^= rngState << 13;
+    rngState ^= rngState >> 17;
+    rngState ^= rngState << 5;
+    return (rngState >> 8) * (1.0f / 16777216.0f);
+}
+
+bool ParticleSystem::spawn(float px, float py, float pz, float vx, float vy, float vz,
+                           float lifetime, float particleSize, uint32_t argb, ParticleBlend mode,
+                           float grav, float dragPerSecond)
+{
+    if (count == CAPACITY || lifetime <= 0.0f)
+        return false;
+
+    int i = count++;
+    x[i] = prevX[i] = px;
+    y[i] = prevY[i] = py;
+    z[i] = prevZ[i] = pz;
+    velX[i] = vx;
+    velY[i] = vy;
+    velZ[i] = vz;
+    life[i] = lifetime;
+    invLife[i] = 1.0f / lifetime;
+    size[i] = particleSize;
+    gravity[i] = grav;
+    drag[i] = dragPerSecond;
+    color[i] = argb;
+    blend[i] = (uint8_t)mode;
+    return true;
+}
+
+void ParticleSystem::burst(ParticleEffect effect, float px, float py, float pz, int n,
+                           float dirX, float dirY)
+{
+    const EffectStyle& s = styleOf(effect);
+
+    bool aimed = dirX != 0.0f || dirY != 0.0f;
+    float baseAngle = aimed ? std::atan2(dirY, dirX) : 0.0f;
+
+    for (int k = 0; k < n; k++) {
+        float a = aimed ? baseAngle + (random() * 2.0f - 1.0f) * s.arc
+                        : random() * 6.2831853f;
+        float speed = s.speedMin + (s.speedMax - s.speedMin) * random();
+
+        if (!spawn(px, py, pz,
+                   std::cos(a) * speed,
+                   std::sin(a) * speed,
+                   s.riseMin + (s.riseMax - s.riseMin) * random(),
+                   s.lifeMin + (s.lifeMax - s.lifeMin) * random(),
+                   s.sizeMin + (s.sizeMax - s.sizeMin) * random(),
+                   s.color, s.blend, s.gravity, s.drag))
+            return;
+    }
+}
+
+void ParticleSystem::emitLavaEmbers(const Map& map, float px, float py, float dt) {
+    emberBudget += EMBER_TRIES_PER_SECOND * dt;
+
+    int cx = int(px);
+    int cy = int(py);
+    int span = EMBER_RADIUS * 2 + 1;
+
+    // Random tiles nearby, so the ember count follows how much lava is around
+    while (emberBudget >= 1.0f) {
+        emberBudget -= 1.0f;
+
+        int tx = cx - EMBER_RADIUS + int(random() * span);
+        int ty = cy - EMBER_RADIUS + int(random() * span);
+        if (tx < 0 || ty < 0 || tx >= map.width || ty >= map.height)
+            continue;
+        if (!(map.flagsFast(tx, ty) & Map::FLAG_LAVA))
+            continue;
+
+        burst(ParticleEffect::Ember, tx + random(), ty + random(), map.heightFast(tx, ty) + 0.02f, 1);
+    }
+}
+
+void ParticleSystem::update(float dt, const Map& map) {
+    if (count == 0)
+        return;
+
+    float* px = x.data();
+    float* py = y.data();
+    float* pz = z.data();
+    float* vx = velX.data();
+    float* vy = velY.data();
+    float* vz = velZ.data();
+    float* lf = life.data();
+    const float* grav = gravity.data();
+    const float* drg = drag.data();
+
+    std::copy(px, px + count, prevX.data());
+    std::copy(py, py + count, prevY.data());
+    std::copy(pz, pz + count, prevZ.data());
+
+    // No branches or lookups, straight arithmetic over the arrays
+    for (int i = 0; i < count; i++) {
+        float keep = std::max(0.0f, 1.0f - drg[i] * dt);
+        vx[i] *= keep;
+        vy[i] *= keep;
+        vz[i] = vz[i] * keep - grav[i] * dt;
+
+        px[i] += vx[i] * dt;
+        py[i] += vy[i] * dt;
+        pz[i] += vz[i] * dt;
+        lf[i] -= dt;
+    }
+
+    int i = 0;
+    while (i < count) {
+        int tx = int(std::floor(px[i]));
+        int ty = int(std::floor(py[i]));
+
+        bool dead = lf[i] <= 0.0f ||
+                    tx < 0 || ty < 0 || tx >= map.width || ty >= map.height ||
+                    pz[i] < map.heightFast(tx, ty);
+
+        if (dead) {
+            remove(i);
+            continue;
+        }
+        i++;
+    }
+}
+
+void ParticleSystem::remove(int i) {
+    int last = --count;
+    x[i] = x[last];
+    y[i] = y[last];
+    z[i] = z[last];
+    prevX[i] = prevX[last];
+    prevY[i] = prevY[last];
+    prevZ[i] = prevZ[last];
+    velX[i] = velX[last];
+    velY[i] = velY[last];
+    velZ[i] = velZ[last];
+    life[i] = life[last];
+    invLife[i] = invLife[last];
+    size[i] = size[last];
+    gravity[i] = gravity[last];
+    drag[i] = drag[last];
+    color[i] = color[last];
+    blend[i] = blend[last];
+}
+
+void ParticleSystem::render(uint32_t* pixels, int screenW, int screenH, const Player& player,
+                            const float* zBuffer, const float* colWallTop) const
+{
+    if (count == 0)
+        return;
+
+    // Unsorted: alpha particles first, then additive ones, which don't care about order
+    drawPass(ParticleBlend::Alpha, pixels, screenW, screenH, player, zBuffer, colWallTop);
+    drawPass(ParticleBlend::Additive, pixels, screenW, screenH, player, zBuffer, colWallTop);
+}
+
+void ParticleSystem::drawPass(ParticleBlend pass, uint32_t* pixels, int screenW, int screenH,
+                              const Player& player, const float* zBuffer, const float* colWallTop) const
+{
+    // Camera vectors
+    float dirX = std::cos(player.angle);
+    float dirY = std::sin(player.angle);
+    float planeX = -dirY * 0.66f;
+    float planeY = dirX * 0.66f;
+
+    float invDet = 1.0f / (planeX * dirY - dirX * planeY);
+    bool additive = pass == ParticleBlend::Additive;
+
+    for (int i = 0; i < count; i++) {
+        if (blend[i] != (uint8_t)pass) continue;
+
+        float px = prevX[i] + (x[i] - prevX[i]) * viewAlpha;
+        float py = prevY[i] + (y[i] - prevY[i]) * viewAlpha;
+        float pz = prevZ[i] + (z[i] - prevZ[i]) * viewAlpha;
+
+        float dx = px - player.x;
+        float dy = py - player.y;
+
+        // Transform to camera space
+        float transformX = invDet * ( dirY * dx - dirX * dy);
+        float transformY = invDet * (-planeY * dx + planeX * dy);
+
+        if (transformY <= 0.05f) continue; // behind camera
+
+        int screenX = int((screenW / 2.0f) * (1 + transformX / transformY));
+        int screenY = int(screenH / 2 - (pz - player.z) / transformY * screenH);
+        int quad = std::max(1, int(screenH / transformY * size[i]));
+
+        int x0 = std::max(0, screenX - quad / 2);
+        int x1 = std::min(screenW, screenX - quad / 2 + quad);
+        int y0 = std::max(0, screenY - quad / 2);
+        int y1 = std::min(screenH, screenY - quad / 2 + quad);
+        if (x0 >= x1 || y0 >= y1) continue;
+
+        // Opacity 0-256, fading out with the time left
+        uint32_t c = color[i];
+        int a = int((c >> 24) * std::min(1.0f, life[i] * invLife[i]) * (256.0f / 255.0f));
+        if (a <= 0) continue;
+
+        int sr = (c >> 16) & 0xFF;
+        int sg = (c >> 8) & 0xFF;
+        int sb = c & 0xFF;
+
+        if (additive) {
+            sr = (sr * a) >> 8;
+            sg = (sg * a) >> 8;
+            sb = (sb * a) >> 8;
+        }
+
+        for (int sx = x0; sx < x1; sx++) {
+            // Behind a wall, only the part above its top shows
+            int clipEnd = y1;
+            if (zBuffer[sx] < transformY)
+                clipEnd = std::min(y1, int(std::ceil(colWallTop[sx])));
+
+            for (int sy = y0; sy < clipEnd; sy++) {
+                uint32_t& dst = pixels[sy * screenW + sx];
+                int dr = (dst >> 16) & 0xFF;
+                int dg = (dst >> 8) & 0xFF;
+                int db = dst & 0xFF;
+
+                if (additive) {
+                    dr = std::min(255, dr + sr);
+                    dg = std::min(255, dg + sg);
+                    db = std::min(255, db + sb);
+                } else {
+                    dr += ((sr - dr) * a) >> 8;
+                    dg += ((sg - dg) * a) >> 8;
+                    db += ((sb - db) * a) >> 8;
+                }
+
+                dst = 0xFF000000 | (uint32_t(dr) << 16) | (uint32_t(dg) << 8) | uint32_t(db);
+            }
+        }
+    }
+}
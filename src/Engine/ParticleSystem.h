@@ -0,0 +1,85 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "Map.h"
+
+class Player;
+
+enum class ParticleBlend : uint8_t {
+    Alpha,     // covers what is behind, smoke and blood
+    Additive   // brightens what is behind, sparks and embers
+};
+
+enum class ParticleEffect {
+    Blood,
+    Sparks,
+    Smoke,
+    Ember
+};
+
+// World-space particles for the software renderer. A fixed pool of CAPACITY
+// kept as struct-of-arrays with the live particles packed at the front.
+// Integration is one straight pass over the float arrays the compiler can
+// vectorize, dead particles are swapped out in a second pass. Drawn after
+// the world as small square quads, clipped per column against the walls.
+class ParticleSystem {
+public:
+    static constexpr int CAPACITY = 8192;
+
+    // Lava embers: random tiles tried per second around the player, and how far out
+    static constexpr float EMBER_TRIES_PER_SECOND = 240.0f;
+    static constexpr int EMBER_RADIUS = 8;
+
+    ParticleSystem();
+
+    // color is ARGB, its alpha the starting opacity, which fades out over life.
+    // Negative gravity rises. False (dropped) when the pool is full.
+    bool spawn(float x, float y, float z, float velX, float velY, float velZ,
+               float life, float size, uint32_t color, ParticleBlend blend,
+               float gravity, float drag);
+
+    // count particles of a preset look, sprayed around dirX/dirY (0, 0 = every way)
+    void burst(ParticleEffect effect, float x, float y, float z, int count,
+               float dirX = 0.0f, float dirY = 0.0f);
+
+    void emitLavaEmbers(const Map& map, float px, float py, float dt);
+
+    // One simulation tick, particles below the floor or inside a wall die
+    void update(float dt, const Map& map);
+
+    void render(uint32_t* pixels, int screenW, int screenH, const Player& player,
+                const float* zBuffer, const float* colWallTop) const;
+
+    void clear() { count = 0; }
+    int activeCount() const { return count; }
+
+    // Where between the last two ticks to draw, set by GameSession for the world draw
+    float viewAlpha = 1.0f;
+
+private:
+    int count = 0;
+
+    // [0, count) are live
+    std::vector<float> x, y, z;
+    std::vector<float> prevX, prevY, prevZ;
+    std::vector<float> velX, velY, velZ;
+    std::vector<float> life;     // seconds left
+    std::vector<float> invLife;  // 1 / starting life, for the fade
+    std::vector<float> size;     // world units
+    std::vector<float> gravity;
+    std::vector<float> drag;     // fraction of speed lost per second
+    std::vector<uint32_t> color;
+    std::vector<uint8_t> blend;
+
+    uint32_t rngState = 0x9E3779B9u;
+    float emberBudget = 0.0f;
+
+    // [0, 1)
+    float random();
+
+    // Swap the last live particle into i
+    void remove(int i);
+
+    void drawPass(ParticleBlend pass, uint32_t* pixels, int screenW, int screenH,
+                  const Player& player, const float* zBuffer, const float* colWallTop) const;
+};
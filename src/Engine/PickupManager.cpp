@@ -1,12 +1,22 @@
 #include "PickupManager.h"
 #include "Player.h"
 #include "Map.h"
+#include "GameSnapshot.h"
 #include <algorithm>
 #include <cmath>
 #include <iostream>
 #include "../third_party/stb_image_wrapper.h"
 #include "../Utils/PathUtils.h"
 
+PickupManager::PickupManager() {
+    grid.init(Map::FALLBACK_SIZE, Map::FALLBACK_SIZE, MAX_PICKUPS);
+}
+
+void PickupManager::setWorldSize(int width, int height) {
+    grid.init(width, height, MAX_PICKUPS);
+    rebuildGrid();
+}
+
 // Helper to load a PNG into a PickupVisual
 bool PickupManager::loadPickupFrame(const std::string& path, PickupVisual& out) {
     std::string fullPath = resolvePath(path);
@@ -86,6 +96,13 @@ void PickupManager::addPickup(float x, float y, float z, PickupType type, Weapon
     p.visual = &pickupsVisuals.at({ type, id });
 
     pickups.push_back(p);
+    grid.insert((int)pickups.size() - 1, x, y);
+}
+
+void PickupManager::rebuildGrid() {
+    grid.clear();
+    for (int i = 0; i < (int)pickups.size(); i++)
+        grid.insert(i, pickups[i].x, pickups[i].y);
 }
 
 // Render pickups in world space
@@ -202,12 +219,12 @@ void PickupManager::applyPickup(Pickup& p, Player& player, Weapon& weapon, Audio
     switch (p.type) {
         case PickupType::Health:
             player.health = std::min(player.maxHealth, player.health + 50);
-            audio.playSFX("heal_pickup");
+            audio.playSFX(SfxId::HealPickup);
             break;
 
         case PickupType::Armor:
             player.armor = std::min(player.maxArmor, player.armor + 25);
-            audio.playSFX("armor_pickup");
+            audio.playSFX(SfxId::ArmorPickup);
             break;
 
         case PickupType::Ammo:
@@ -218,7 +235,7 @@ void PickupManager::applyPickup(Pickup& p, Player& player, Weapon& weapon, Audio
                         weapon.pReserveAmmo + 8,
                         weapon.pMaxReserve
                     );
-                    audio.playSFX("ammo_pickup");
+                    audio.playSFX(SfxId::AmmoPickup);
                     break;
 
                 case WeaponType::Shotgun:
@@ -226,7 +243,7 @@ void PickupManager::applyPickup(Pickup& p, Player& player, Weapon& weapon, Audio
                         weapon.sReserveAmmo + 4,
                         weapon.sMaxReserve
                     );
-                    audio.playSFX("ammo_pickup");
+                    audio.playSFX(SfxId::AmmoPickup);
                     break;
 
                 case WeaponType::Mg:
@@ -234,7 +251,7 @@ void PickupManager::applyPickup(Pickup& p, Player& player, Weapon& weapon, Audio
                         weapon.mgReserveAmmo + 30,
                         weapon.mgMaxReserve
                     );
-                    audio.playSFX("ammo_pickup"); 
+                    audio.playSFX(SfxId::AmmoPickup); 
                     break;
 
                 default:
@@ -245,7 +262,7 @@ void PickupManager::applyPickup(Pickup& p, Player& player, Weapon& weapon, Audio
         case PickupType::Weapon:
             // p.id can store the WeaponType to give
             player.giveItem(static_cast<ItemType>(p.id));
-            audio.playSFX("gun_pickup");
+            audio.playSFX(SfxId::GunPickup);
             break;
     }
 
@@ -253,11 +270,38 @@ void PickupManager::applyPickup(Pickup& p, Player& player, Weapon& weapon, Audio
     p.active = false;
 }
 
+void PickupManager::clear() {
+    pickups.clear();
+    grid.clear();
+}
+
+void PickupManager::saveSnapshot(GameSnapshot& out) const {
+    out.pickupCount = 0;
+
+    for (const Pickup& p : pickups) {
+        if (!p.active) continue;
+        out.pickups[out.pickupCount++] = { p.x, p.y, p.z, p.type, p.id };
+    }
+}
+
+void PickupManager::restoreSnapshot(const GameSnapshot& in) {
+    clear();
+
+    for (int i = 0; i < in.pickupCount; i++) {
+        const PickupSnapshot& p = in.pickups[i];
+        addPickup(p.x, p.y, p.z, p.type, p.id);
+    }
+}
+
 void PickupManager::update(Player& player, float deltaTime, Weapon& weapon, AudioManager& audio) {
     const float PICKUP_RADIUS = 0.5f; // distance at which player collects the pickup
 
-    for (Pickup& p : pickups) {
-        if (!p.active) continue;
+    bool collected = false;
+
+    // Only pickups in the tiles around the player can be touched
+    grid.forEachNear(player.x, player.y, PICKUP_RADIUS, [&](int i) {
+        Pickup& p = pickups[i];
+        if (!p.active) return;
 
         // Compute distance to player in 2D (ignore height for pickup collection)
         float dx = p.x - player.x;
@@ -267,13 +311,18 @@ void PickupManager::update(Player& player, float deltaTime, Weapon& weapon, Audi
         if (distSq <= PICKUP_RADIUS * PICKUP_RADIUS) {
             // Player is close enough — apply pickup effect
             applyPickup(p, player, weapon, audio);
+            collected = true;
         }
-    }
+    });
+
+    if (!collected)
+        return;
 
-    // Optional cleanup: remove collected pickups
+    // Remove collected pickups, indices shift so the grid is rebuilt
     pickups.erase(
         std::remove_if(pickups.begin(), pickups.end(),
             [](const Pickup& p) { return !p.active; }),
         pickups.end()
     );
+    rebuildGrid();
 }
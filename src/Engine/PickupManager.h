@@ -3,6 +3,7 @@
 #include <unordered_map>
 #include <cstdint>
 #include "WeaponTypes.h"
+#include "SpatialGrid.h"
 #include "../audio/AudioManager.h"
 
 struct pair_hash {
@@ -36,11 +37,14 @@ struct Pickup {
 class Player;
 class Map;
 class Weapon;
+struct GameSnapshot;
 
 class PickupManager {
 public:
     static constexpr int MAX_PICKUPS = 64;
 
+    PickupManager();
+
     std::vector<Pickup> pickups;
     // key: pair of PickupType + WeaponType
     std::unordered_map<std::pair<PickupType, WeaponType>, PickupVisual, pair_hash> pickupsVisuals;
@@ -48,6 +52,9 @@ public:
     // Load all pickup textures
     void loadPickupAssets();
 
+    // Size the pickup grid to the level
+    void setWorldSize(int width, int height);
+
     // Spawn a pickup into the world
     void addPickup(float x, float y, float z, PickupType type, WeaponType id);
 
@@ -57,7 +64,18 @@ public:
 
     void update(Player& player, float deltaTime, Weapon& weapon, AudioManager& audio);
 
+    // Remove all world pickups (visuals stay loaded)
+    void clear();
+
+    // Wave checkpoint save / restore of world pickups
+    void saveSnapshot(GameSnapshot& out) const;
+    void restoreSnapshot(const GameSnapshot& in);
+
 private:
+    // Pickups bucketed by tile, ids are indices into pickups
+    SpatialGrid grid;
+    void rebuildGrid();
+
     bool loadPickupFrame(const std::string& path, PickupVisual& out);
 
     void applyPickup(Pickup& p, Player& player, Weapon& weapon, AudioManager& audio);
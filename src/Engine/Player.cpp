@@ -1,5 +1,8 @@
 #include "Player.h"
 #include "WeaponManager.h"
+#include "GameSnapshot.h"
+#include "Hitscan.h"
+#include "Collision.h"
 
 void Player::renderDamageFlash(uint32_t* pixels, int screenW, int screenH, float intensity)
 {
@@ -104,7 +107,8 @@ void Player::applyDamage(int damage, float shieldMultiplier)
     }
 }
 
-void Player::update(float delta, const uint8_t* keys, Map& map, EnemyManager& enemyManager, WeaponManager& weaponManager, Weapon& weapon, GameState& gs, AudioManager& audio, BulletHoleManager& bulletHoleManager) {
+void Player::update(float delta, const uint8_t* keys, Map& map, EnemyManager& enemyManager, WeaponManager& weaponManager, Weapon& weapon, GameState& gs, AudioManager& audio, BulletHoleManager& bulletHoleManager,
+                    ParticleSystem& particles) {
     // Check if player died
     if (health <= 0) {
         gs = GameState::PlayerDead;
@@ -138,7 +142,7 @@ void Player::update(float delta, const uint8_t* keys, Map& map, EnemyManager& en
             if (lavaTickTimer <= 0.0f)
             {
                 applyDamage(lavaDamage, 0.25f);
-                audio.playSFX("lava_burn");
+                audio.playSFX(SfxId::LavaBurn);
                 lavaTickTimer = lavaTickInterval;
             }
         }
@@ -159,7 +163,7 @@ void Player::update(float delta, const uint8_t* keys, Map& map, EnemyManager& en
         inputX += std::cos(angle);
         inputY += std::sin(angle);
         if (onGround == true && footstepTimer <= 0.0f) {
-            audio.playSFX("walk");
+            audio.playSFX(SfxId::Walk);
             footstepTimer = 0.30f;
         }
     }
@@ -168,7 +172,7 @@ void Player::update(float delta, const uint8_t* keys, Map& map, EnemyManager& en
         inputX -= std::cos(angle);
         inputY -= std::sin(angle);
         if (onGround == true && footstepTimer <= 0.0f) {
-            audio.playSFX("walk");
+            audio.playSFX(SfxId::Walk);
             footstepTimer = 0.30f;
         }
     }
@@ -177,7 +181,7 @@ void Player::update(float delta, const uint8_t* keys, Map& map, EnemyManager& en
         velZ = JUMP_VELOCITY;
         onGround = false;
         z += 0.001;
-        audio.playSFX("jump");
+        audio.playSFX(SfxId::Jump);
     }
 
     // Normalize input so diagonal isn’t faster
@@ -232,27 +236,23 @@ void Player::update(float delta, const uint8_t* keys, Map& map, EnemyManager& en
         velY = (velY / speedNow) * MAX_SPEED;
     }
 
-    // Proposed new position
-    float newX = x + velX * delta;
-    float newY = y + velY * delta;
+    // Slide against anything more than a step above the feet
+    CollisionResult moved = Collision::move(map, x, y, velX * delta, velY * delta,
+                                            RADIUS, z - 0.5f, Map::STEP_HEIGHT);
+    x = moved.x;
+    y = moved.y;
+    if (moved.blockedX) velX = 0;
+    if (moved.blockedY) velY = 0;
 
     const float FLOOR_EPSILON = 0.1f; // tolerance so head bob doesn't trigger falling
 
-    // Collision X-axis
-    int tx = int(std::floor(newX));
-    int ty = int(std::floor(y));
-    auto& tileX = map.get(tx, ty);
-
-    float heightDelta = tileX.height - (z - 0.5);
-
-    if (heightDelta <= 0.25f) {
-        x = newX;
+    if (!moved.blockedX || !moved.blockedY) {
+        float floorHeight = map.heightAt(int(std::floor(x)), int(std::floor(y)));
 
         // Update player z to 0.5 greater than tile height
-        float targetZ = 0.5f + tileX.height;
+        float targetZ = 0.5f + floorHeight;
         float diff = z - targetZ;
 
-        // Update player z to 0.5 greater than tile height
         if (onGround && std::fabs(diff) > FLOOR_EPSILON) {
             onGround = false;
 
@@ -261,63 +261,20 @@ void Player::update(float delta, const uint8_t* keys, Map& map, EnemyManager& en
             float maxFallSpeed  = 6.0f;   // maximum speed for tall drops
 
             // Use the tile height as a scaling factor
-            float heightFactor = std::abs(tileX.height); // use absolute for negative pits
+            float heightFactor = std::abs(floorHeight); // use absolute for negative pits
             float fallSpeed = baseFallSpeed + heightFactor * 4.0f;
 
             // Clamp to prevent extreme speed
             fallSpeed = std::clamp(fallSpeed, baseFallSpeed, maxFallSpeed);
 
-            if (z < 0.5f + tileX.height) {
+            if (z < targetZ) {
                 z += fallSpeed * delta;
-                if (z > 0.5f + tileX.height) z = 0.5f + tileX.height; // clamp so we don't overshoot
-            } else if (z > 0.5f + tileX.height) {
+                if (z > targetZ) z = targetZ; // clamp so we don't overshoot
+            } else if (z > targetZ) {
                 z -= fallSpeed * delta;
-                if (z < 0.5f + tileX.height) z = 0.5f + tileX.height;
+                if (z < targetZ) z = targetZ;
             }
         }
-    } else {
-        velX = 0;
-    }
-
-    // Collision Y-axis
-    tx = int(std::floor(x));
-    ty = int(std::floor(newY));
-    auto& tileY = map.get(tx, ty);
-
-    heightDelta = tileY.height - (z - 0.5);
-
-    if (heightDelta <= 0.25f) {
-        y = newY;
-
-        // Update player z to 0.5 greater than tile height
-        float targetZ = 0.5f + tileY.height;
-        float diff = z - targetZ;
-
-        // Update player z to 0.5 greater than tile height
-        if (onGround && std::fabs(diff) > FLOOR_EPSILON) {
-            onGround = false;
-    
-            // Gradually move z toward targetZ
-            float baseFallSpeed = 2.0f;   // minimum speed for tiny steps
-            float maxFallSpeed  = 6.0f;   // maximum speed for tall drops
-            
-            // Use the tile height as a scaling factor
-            float heightFactor = std::abs(tileY.height); // use absolute for negative pits
-            float fallSpeed = baseFallSpeed + heightFactor * 4.0f;                             
-            
-            // Clamp to prevent extreme speed
-            fallSpeed = std::clamp(fallSpeed, baseFallSpeed, maxFallSpeed);
-
-            if (z < 0.5f + tileY.height) {
-                z += fallSpeed * delta;
-                if (z > 0.5f + tileY.height) z = 0.5f + tileY.height; // clamp so we don't overshoot
-            } else if (z > 0.5f + tileY.height) {
-                z -= fallSpeed * delta;
-                if (z < 0.5f + tileY.height) z = 0.5f + tileY.height;
-            }
-        }
-    } else {
-        velY = 0;
     }
 
     // Turning acceleration
@@ -386,7 +343,7 @@ void Player::update(float delta, const uint8_t* keys, Map& map, EnemyManager& en
             weaponManager.startSwap(itemToWeapon(p));
             currentItem = p;
             canSwitchItem = false;
-            audio.playSFX("item_swap");
+            audio.playSFX(SfxId::ItemSwap);
         }
     } else if (keys[SDL_SCANCODE_E]) {
         if (canSwitchItem) {
@@ -394,7 +351,7 @@ void Player::update(float delta, const uint8_t* keys, Map& map, EnemyManager& en
             weaponManager.startSwap(itemToWeapon(n));
             currentItem = n;
             canSwitchItem = false;
-            audio.playSFX("item_swap");
+            audio.playSFX(SfxId::ItemSwap);
         }
     } else {
         canSwitchItem = true; // reset once no item key is pressed
@@ -414,18 +371,18 @@ void Player::update(float delta, const uint8_t* keys, Map& map, EnemyManager& en
             if (leftMouseDown && fireCooldown <= 0.0f) {
                 if (weapon.pClipAmmo <= 0) {
                     weapon.pClipAmmo = 0;
-                    audio.playSFX("gun_click");
+                    audio.playSFX(SfxId::GunClick);
                     fireCooldown = 0.75f;
                 }
                 else {
-                    shoot(enemyManager, weaponManager, map, bulletHoleManager);
+                    shoot(enemyManager, weaponManager, map, bulletHoleManager, particles);
                     fireCooldown = 0.75f; // pistol fires once every 0.75 seconds
 
                     // Start animation
                     isFiringAnim = true;
                     fireFrame = 0;
                     fireFrameTimer = FIRE_FRAME_DURATION;
-                    audio.playSFX("pistol_shoot", 0.6f);
+                    audio.playSFX(SfxId::PistolShoot, 0.6f);
                     weapon.pClipAmmo -= 1;
                 }
             }
@@ -441,18 +398,18 @@ void Player::update(float delta, const uint8_t* keys, Map& map, EnemyManager& en
             if (leftMouseDown && fireCooldown <= 0.0f) {
                 if (weapon.sClipAmmo <= 0) {
                     weapon.sClipAmmo = 0;
-                    audio.playSFX("gun_click");
+                    audio.playSFX(SfxId::GunClick);
                     fireCooldown = 0.75f;
                 }
                 else {
-                    shoot(enemyManager, weaponManager, map, bulletHoleManager);
+                    shoot(enemyManager, weaponManager, map, bulletHoleManager, particles);
                     fireCooldown = 0.75f; // Shotgun fires once every 0.75 seconds
 
                     // Start animation
                     isFiringAnim = true;
                     fireFrame = 0;
                     fireFrameTimer = FIRE_FRAME_DURATION;
-                    audio.playSFX("shotgun_shoot");
+                    audio.playSFX(SfxId::ShotgunShoot);
                     weapon.sClipAmmo -= 2;
                 }
             }
@@ -468,18 +425,18 @@ void Player::update(float delta, const uint8_t* keys, Map& map, EnemyManager& en
             if (leftMouseDown && fireCooldown <= 0.0f) {
                 if (weapon.mgClipAmmo <= 0) {
                     weapon.mgClipAmmo = 0;
-                    audio.playSFX("gun_click");
+                    audio.playSFX(SfxId::GunClick);
                     fireCooldown = 0.7f;
                 }
                 else {
-                    shoot(enemyManager, weaponManager, map, bulletHoleManager);
+                    shoot(enemyManager, weaponManager, map, bulletHoleManager, particles);
                     fireCooldown = 0.1f; // Mg fires once every 0.1 seconds
              
                     // Start animation
                     isFiringAnim = true;
                     fireFrame = 0;  
                     fireFrameTimer = 0.01;
-                    audio.playSFX("mg_shoot");
+                    audio.playSFX(SfxId::MgShoot);
                     weapon.mgClipAmmo -= 1;
                 }
             }    
@@ -495,7 +452,7 @@ void Player::update(float delta, const uint8_t* keys, Map& map, EnemyManager& en
                 reloadFrameTimer = RELOAD_FRAME_DURATION;
                 reloadKeyPressed = true;
                 weaponManager.playReloadAnimation(itemToWeapon(currentItem));
-                audio.playSFX("shotgun_reload");
+                audio.playSFX(SfxId::ShotgunReload);
 
                 // Checks if reserve is less than max clip size and if so sets clip size to reserve
                 if (weapon.sReserveAmmo < weapon.sClipSize && weapon.sReserveAmmo > 0) {
@@ -514,7 +471,7 @@ void Player::update(float delta, const uint8_t* keys, Map& map, EnemyManager& en
                 reloadFrameTimer = RELOAD_FRAME_DURATION;
                 reloadKeyPressed = true;
                 weaponManager.playReloadAnimation(itemToWeapon(currentItem));
-                audio.playSFX("pistol_reload");
+                audio.playSFX(SfxId::PistolReload);
                 
                 // Checks if reserve is less than max clip size and if so sets clip size to reserve
                 if (weapon.pReserveAmmo < weapon.pClipSize && weapon.pReserveAmmo > 0) {
@@ -539,7 +496,7 @@ void Player::update(float delta, const uint8_t* keys, Map& map, EnemyManager& en
                 reloadFrameTimer = RELOAD_FRAME_DURATION;
                 reloadKeyPressed = true;
                 weaponManager.playReloadAnimation(itemToWeapon(currentItem));
-                audio.playSFX("mg_reload");
+                audio.playSFX(SfxId::MgReload);
             
                 // Checks if reserve is less than max clip size and if so sets clip size to reserve
                 if (weapon.mgReserveAmmo < weapon.mgClipSize && weapon.mgReserveAmmo > 0) {
@@ -620,23 +577,33 @@ void Player::update(float delta, const uint8_t* keys, Map& map, EnemyManager& en
     }
 
 
-    // Gets current 10x10 chunk the player is in
-    int currentChunk = map.getChunkID(int(std::floor(x)), int(std::floor(y)));
+    // Gets current 10x10 chunk the player is in, enemies schedule their AI around it
+    lastChunkID = map.getChunkID(int(std::floor(x)), int(std::floor(y)));
 }
 
-void Player::shoot(EnemyManager& manager, WeaponManager& weaponManager, Map& map, BulletHoleManager& bulletHoleManager)
+void Player::shoot(EnemyManager& manager, WeaponManager& weaponManager, Map& map, BulletHoleManager& bulletHoleManager,
+                   ParticleSystem& particles)
 {
     // Keep track of shots fired
     shotsFired += 1;
 
     const float maxRange = 10.0f;
 
-    float hitWidth = 0.0f;
+    // Shotgun fires a fan of pellets, everything else a single ray
+    int pellets = 1;
+    float spread = 0.0f;
+    float hitWidth = 0.15f;
+    int damage = 0;
+
     switch(currentItem) {
-        case ItemType::Pistol: hitWidth = 0.15f; break;
-        case ItemType::Mg: hitWidth = 0.15f; break;
-        case ItemType::Shotgun: hitWidth = 0.25f; break;
-        default: hitWidth = 0.15; break;
+        case ItemType::Pistol: damage = 50; break;
+        case ItemType::Mg: damage = 25; break;
+        case ItemType::Shotgun:
+            pellets = SHOTGUN_PELLETS;
+            spread = SHOTGUN_SPREAD;
+            damage = SHOTGUN_PELLET_DAMAGE;
+            break;
+        default: break;
     }
 
     WeaponType wt = itemToWeapon(currentItem);
@@ -644,101 +611,98 @@ void Player::shoot(EnemyManager& manager, WeaponManager& weaponManager, Map& map
     if (wt != WeaponType::None)
         weaponManager.playShootAnimation(wt);
 
-    float dirX = std::cos(angle);
-    float dirY = std::sin(angle);
-
-    const float fovScale = 0.66f;
-    float planeX = -dirY * fovScale;
-    float planeY =  dirX * fovScale;
+    static_assert(SHOTGUN_PELLETS <= Hitscan::MAX_BATCH, "one castBatch pass per shot");
+    HitscanRay rays[SHOTGUN_PELLETS];
+    HitscanHit hits[SHOTGUN_PELLETS];
 
-    bool enemyHit = false;
-
-    // Check for enemy hits
-    for (int i = 0; i < manager.MAX_ENEMIES; i++) {
-        Enemy& e = manager.enemies[i];
-        if (e.active == false || e.deathAnimFinished == true) continue;
+    for (int p = 0; p < pellets; p++) {
+        // Evenly across the spread, center pellet straight ahead
+        float offset = (pellets > 1) ? (float(p) / (pellets - 1) * 2.0f - 1.0f) * spread : 0.0f;
+        rays[p].dirX = std::cos(angle + offset);
+        rays[p].dirY = std::sin(angle + offset);
+        rays[p].hitWidth = hitWidth;
+    }
 
-        float dx = e.x - x;
-        float dy = e.y - y;
-        float dist = std::sqrt(dx*dx + dy*dy);
-        if (dist > maxRange) continue;
+    Hitscan::castBatch(map, manager, x, y, z, rays, pellets, maxRange, hits);
 
-        float invDet = 1.0f / (planeX * dirY - dirX * planeY);
+    bool enemyHit = false;
 
-        float transformX = invDet * (dirY * dx - dirX * dy);
-        float transformY = invDet * (-planeY * dx + planeX * dy);
+    for (int p = 0; p < pellets; p++) {
+        if (hits[p].type == HitscanHit::Type::Wall) {
+            // Sparks thrown back off the wall, from just in front of it
+            const RayHit& w = hits[p].wall;
+            particles.burst(ParticleEffect::Sparks,
+                            w.hitX - rays[p].dirX * 0.05f, w.hitY - rays[p].dirY * 0.05f, z, 4,
+                            -rays[p].dirX, -rays[p].dirY);
+        }
 
-        if (transformY <= 0) continue;
+        if (hits[p].type != HitscanHit::Type::Enemy) continue;
 
-        // World-space perpendicular distance from shot line
-        float perpDist = std::abs(dy * dirX - dx * dirY);
+        int slot = hits[p].enemySlot;
+        manager.damageEnemy(slot, damage);
+        enemyHit = true;
 
-        if (perpDist < hitWidth) {
-            if (!e.hasLineOfSight(*this, map)) continue;
+        const EnemyHot& hot = manager.hot;
+        particles.burst(ParticleEffect::Blood, hot.x[slot], hot.y[slot],
+                        hot.z[slot] + hot.height[slot] * 0.6f, 6, rays[p].dirX, rays[p].dirY);
+    }
 
-            // Apply damage
-            int damage = 0;
-            if (currentItem == ItemType::Pistol) damage = 50;
-            else if (currentItem == ItemType::Shotgun) damage = 250;
-            else if (currentItem == ItemType::Mg) damage = 25;
+    // Muzzle smoke a little ahead of and below the eye
+    float aimX = std::cos(angle);
+    float aimY = std::sin(angle);
+    particles.burst(ParticleEffect::Smoke, x + aimX * 0.35f, y + aimY * 0.35f, z - 0.12f, 3, aimX, aimY);
 
-            shotsHit += 1;
-            e.takeDamage(damage);
+    if (enemyHit)
+        shotsHit += 1;
 
-            enemyHit = true;
-            break;
-        }
-    }
+    // Bullet hole where the center ray met a wall
+    const HitscanHit& center = hits[pellets / 2];
 
-    // Wall hit (bullet hole) if no enemy was hit
-    if (!enemyHit) {
-        RayHit wallHit;
-        if (map.raycastWall(x, y, dirX, dirY, maxRange, wallHit)) {
+    if (center.type == HitscanHit::Type::Wall) {
+        const RayHit& wallHit = center.wall;
+        float dirX = rays[pellets / 2].dirX;
+        float dirY = rays[pellets / 2].dirY;
 
-            bool verticalWall = wallHit.vertical;
+        bool verticalWall = wallHit.vertical;
 
-            float correctedFraction = wallHit.hitFraction;
+        float correctedFraction = wallHit.hitFraction;
 
-            if (!verticalWall && dirY < 0)
-                correctedFraction = 1.0f - wallHit.hitFraction;   // flip for up-going rays
+        if (!verticalWall && dirY < 0)
+            correctedFraction = 1.0f - wallHit.hitFraction;   // flip for up-going rays
 
-            GridSegment::Dir face;
+        GridSegment::Dir face;
 
-            if (verticalWall) {
-                if (dirX > 0)
-                    face = GridSegment::Dir::West;   // ray moving east hit west face
-                else
-                    face = GridSegment::Dir::East;   // ray moving west hit east face
-            } else {
-                if (dirY > 0)
-                    face = GridSegment::Dir::North;  // ray moving south hit north face
-                else
-                    face = GridSegment::Dir::South;  // ray moving north hit south face
-            }
+        if (verticalWall) {
+            if (dirX > 0)
+                face = GridSegment::Dir::West;   // ray moving east hit west face
+            else
+                face = GridSegment::Dir::East;   // ray moving west hit east face
+        } else {
+            if (dirY > 0)
+                face = GridSegment::Dir::North;  // ray moving south hit north face
+            else
+                face = GridSegment::Dir::South;  // ray moving north hit south face
+        }
 
-            // Spawn bullet hole on that tile if tile.height > player.height
-            if (map.get(wallHit.tileX, wallHit.tileY).height > z) {
-                if (currentItem == ItemType::Pistol || currentItem == ItemType::Mg) {
-                    bulletHoleManager.spawn(
-                        wallHit.tileX,
-                        wallHit.tileY,
-                        z,
-                        face,
-                        correctedFraction,
-                        BulletHoleType::Pistol
-                    );
-                }
-                else if (currentItem == ItemType::Shotgun) {
-                    bulletHoleManager.spawn(
-                        wallHit.tileX,
-                        wallHit.tileY,
-                        z,
-                        face,
-                        correctedFraction,
-                        BulletHoleType::Shotgun
-                    );
-                }
-            }
+        if (currentItem == ItemType::Pistol || currentItem == ItemType::Mg) {
+            bulletHoleManager.spawn(
+                wallHit.tileX,
+                wallHit.tileY,
+                z,
+                face,
+                correctedFraction,
+                BulletHoleType::Pistol
+            );
+        }
+        else if (currentItem == ItemType::Shotgun) {
+            bulletHoleManager.spawn(
+                wallHit.tileX,
+                wallHit.tileY,
+                z,
+                face,
+                correctedFraction,
+                BulletHoleType::Shotgun
+            );
         }
     }
 
@@ -749,6 +713,66 @@ void Player::shoot(EnemyManager& manager, WeaponManager& weaponManager, Map& map
     fireFrameTimer = FIRE_FRAME_DURATION;
 }
 
+void Player::reset() {
+    // Keep the inventory allocation around between runs
+    std::vector<ItemType> items = std::move(inventory);
+    items.clear();
+
+    *this = Player();
+
+    inventory = std::move(items);
+}
+
+void Player::saveSnapshot(PlayerSnapshot& out) const {
+    out.health = health;
+    out.armor = armor;
+
+    out.x = x;
+    out.y = y;
+    out.z = z;
+    out.angle = angle;
+    out.velX = velX;
+    out.velY = velY;
+    out.velZ = velZ;
+    out.turnVel = turnVel;
+    out.baseZ = baseZ;
+    out.onGround = onGround;
+
+    out.currentItem = currentItem;
+    out.inventoryCount = std::min((int)inventory.size(), PlayerSnapshot::MAX_INVENTORY);
+    for (int i = 0; i < out.inventoryCount; i++)
+        out.inventory[i] = inventory[i];
+
+    out.shotsFired = shotsFired;
+    out.shotsHit = shotsHit;
+    out.timeElapsed = timeElapsed;
+}
+
+void Player::restoreSnapshot(const PlayerSnapshot& in) {
+    reset();
+
+    health = in.health;
+    armor = in.armor;
+
+    x = in.x;
+    y = in.y;
+    z = in.z;
+    angle = in.angle;
+    velX = in.velX;
+    velY = in.velY;
+    velZ = in.velZ;
+    turnVel = in.turnVel;
+    baseZ = in.baseZ;
+    onGround = in.onGround;
+
+    currentItem = in.currentItem;
+    inventory.assign(in.inventory, in.inventory + in.inventoryCount);
+
+    shotsFired = in.shotsFired;
+    shotsHit = in.shotsHit;
+    timeElapsed = in.timeElapsed;
+}
+
 void Player::giveItem(ItemType item) {
     inventory.push_back(item);
 }
@@ -9,10 +9,12 @@
 #include <vector>
 #include "WeaponTypes.h"
 #include "BulletHoleManager.h"
+#include "ParticleSystem.h"
 #include "GameState.h"
 #include "../audio/AudioManager.h"
 
 class WeaponManager;
+struct PlayerSnapshot;
 
 enum class ItemType {
     None,
@@ -47,17 +49,19 @@ public:
 
     bool onGround = true;
 
-    const float ACCEL = 14.0f;       // how fast player reaches max speed
-    const float FRICTION = 8.0f;    // how fast player slides to a stop
-    const float MAX_SPEED = 6.0f;   // top movement speed
+    static constexpr float ACCEL = 14.0f;       // how fast player reaches max speed
+    static constexpr float FRICTION = 8.0f;    // how fast player slides to a stop
+    static constexpr float MAX_SPEED = 6.0f;   // top movement speed
 
     float turnVel = 0.0f;
-    const float TURN_ACCEL = 10.0f;    // how fast turning speeds up
-    const float TURN_FRICTION = 14.0f; // how fast turning slows down
-    const float MAX_TURN_SPEED = 2.5f; // top turning speed
+    static constexpr float TURN_ACCEL = 10.0f;    // how fast turning speeds up
+    static constexpr float TURN_FRICTION = 14.0f; // how fast turning slows down
+    static constexpr float MAX_TURN_SPEED = 2.5f; // top turning speed
 
-    const float JUMP_VELOCITY = 3.0f;
-    const float GRAVITY = 9.8f;
+    static constexpr float JUMP_VELOCITY = 3.0f;
+
+    static constexpr float RADIUS = 0.2f; // collision footprint
+    static constexpr float GRAVITY = 9.8f;
 
     ItemType currentItem = ItemType::None;
     std::vector<ItemType> inventory;
@@ -72,6 +76,11 @@ public:
     float fireFrameTimer = 0.0f;
 
     static constexpr float FIRE_FRAME_DURATION = 0.05f; // 50ms per frame
+
+    // Shotgun pellet fan, total damage about the old single 250 hit
+    static constexpr int SHOTGUN_PELLETS = 7;
+    static constexpr float SHOTGUN_SPREAD = 0.08f; // radians either side of center
+    static constexpr int SHOTGUN_PELLET_DAMAGE = 36;
     static constexpr int PISTOL_FIRE_FRAMES = 6; // idle + 5 Pistol firing frames
     static constexpr int SHOTGUN_FIRE_FRAMES = 4; // idle + 3 Shotgun firing frames
     static constexpr int MG_FIRE_FRAMES = 7; // idle + 6 Mg firing frames
@@ -81,7 +90,7 @@ public:
     bool reloadKeyPressed = false;
     int reloadFrame = 0;
     float reloadFrameTimer = 0.0f;
-    const float RELOAD_FRAME_DURATION = 0.1f;
+    static constexpr float RELOAD_FRAME_DURATION = 0.1f;
 
     // Footstep sfx
     float footstepTimer = 0.0f;
@@ -90,10 +99,10 @@ public:
     float bobPhase = 0.0f;
     float bobOffset = 0.0f;
     float smoothSpeed = 0.0f;
-    const float MAX_BOB = 0.1f;
-    const float STEP_FREQ = 18.0f;
-    const float SPEED_SMOOTH = 4.0f;
-    const float BOB_SMOOTH = 10.0f;
+    static constexpr float MAX_BOB = 0.1f;
+    static constexpr float STEP_FREQ = 18.0f;
+    static constexpr float SPEED_SMOOTH = 4.0f;
+    static constexpr float BOB_SMOOTH = 10.0f;
     float baseZ;
 
     int lastChunkID;
@@ -103,8 +112,17 @@ public:
         lastChunkID = -1;
     }
 
-    void update(float delta, const uint8_t* keys, Map& map, EnemyManager& enemyManager, WeaponManager& weaponManager, Weapon& weapon, GameState& gs, AudioManager& audio, BulletHoleManager& bulletHoleManager);
-    void shoot(EnemyManager& manager, WeaponManager& weaponManager, Map& map, BulletHoleManager& bulletHoleManager);
+    // Restore spawn state for a new run (keeps inventory capacity)
+    void reset();
+
+    // Wave checkpoint save / restore (transient anim and timer state is reset)
+    void saveSnapshot(PlayerSnapshot& out) const;
+    void restoreSnapshot(const PlayerSnapshot& in);
+
+    void update(float delta, const uint8_t* keys, Map& map, EnemyManager& enemyManager, WeaponManager& weaponManager, Weapon& weapon, GameState& gs, AudioManager& audio, BulletHoleManager& bulletHoleManager,
+                ParticleSystem& particles);
+    void shoot(EnemyManager& manager, WeaponManager& weaponManager, Map& map, BulletHoleManager& bulletHoleManager,
+               ParticleSystem& particles);
 
     void giveItem(ItemType item);
     ItemType nextItem() const;
@@ -0,0 +1,181 @@
+#include "ProjectileManager.h"
+#include "Collision.h"
+#include "Player.h"
+#include <algorithm>
+#include <cmath>
+
+ProjectileManager::ProjectileManager() {
+    x.resize(CAPACITY);
+    y.resize(CAPACITY);
+    z.resize(CAPACITY);
+    prevX.resize(CAPACITY);
+    prevY.resize(CAPACITY);
+    velX.resize(CAPACITY);
+    velY.resize(CAPACITY);
+    life.resize(CAPACITY);
+    damage.resize(CAPACITY);
+    shieldMultiplier.resize(CAPACITY);
+
+    // Hot core fading to a dark orange rim
+    spriteSize = 16;
+    sprite.assign(spriteSize * spriteSize, 0);
+
+    float c = (spriteSize - 1) * 0.5f;
+    for (int sy = 0; sy < spriteSize; sy++) {
+        for (int sx = 0; sx < spriteSize; sx++) {
+            float d = std::sqrt((sx - c) * (sx - c) + (sy - c) * (sy - c)) / (c + 0.5f);
+            if (d > 1.0f)
+                continue;
+
+            float t = 1.0f - d;
+            uint32_t r = 255;
+            uint32_t g = uint32_t(90 + 165 * t * t);
+            uint32_t b = uint32_t(40 + 140 * t * t * t);
+            sprite[sy * spriteSize + sx] = 0xFF000000 | (r << 16) | (g << 8) | b;
+        }
+    }
+}
+
+bool ProjectileManager::spawn(float px, float py, float pz, float dirX, float dirY,
+                              int dmg, float shieldMult)
+{
+    if (count == CAPACITY)
+        return false;
+
+    int i = count++;
+    x[i] = prevX[i] = px;
+    y[i] = prevY[i] = py;
+    z[i] = pz;
+    velX[i] = dirX * SPEED;
+    velY[i] = dirY * SPEED;
+    life[i] = LIFETIME;
+    damage[i] = dmg;
+    shieldMultiplier[i] = shieldMult;
+    return true;
+}
+
+void ProjectileManager::remove(int i) {
+    int last = --count;
+    x[i] = x[last];
+    y[i] = y[last];
+    z[i] = z[last];
+    prevX[i] = prevX[last];
+    prevY[i] = prevY[last];
+    velX[i] = velX[last];
+    velY[i] = velY[last];
+    life[i] = life[last];
+    damage[i] = damage[last];
+    shieldMultiplier[i] = shieldMultiplier[last];
+}
+
+void ProjectileManager::update(float dt, const Map& map, Player& player, ParticleSystem& particles) {
+    // Player body: a circle from the feet to just over eye height
+    const float hitRadius = Player::RADIUS + RADIUS;
+    const float hitRadiusSq = hitRadius * hitRadius;
+    const float feetZ = player.z - 0.5f;
+    const float headZ = player.z + 0.1f;
+
+    int i = 0;
+    while (i < count) {
+        float sx = x[i];
+        float sy = y[i];
+        prevX[i] = sx;
+        prevY[i] = sy;
+
+        // Flies level, anything taller than the shot stops it
+        CollisionResult moved = Collision::move(map, sx, sy, velX[i] * dt, velY[i] * dt,
+                                                RADIUS, z[i], 0.0f);
+        x[i] = moved.x;
+        y[i] = moved.y;
+
+        // Closest point of this tick's path to the player
+        float mx = moved.x - sx;
+        float my = moved.y - sy;
+        float lenSq = mx * mx + my * my;
+        float t = lenSq > 0.0f ? ((player.x - sx) * mx + (player.y - sy) * my) / lenSq : 0.0f;
+        t = std::clamp(t, 0.0f, 1.0f);
+
+        float ox = sx + mx * t - player.x;
+        float oy = sy + my * t - player.y;
+
+        if (ox * ox + oy * oy <= hitRadiusSq && z[i] >= feetZ && z[i] <= headZ) {
+            player.applyDamage(damage[i], shieldMultiplier[i]);
+            remove(i);
+            continue;
+        }
+
+        if (moved.blockedX || moved.blockedY) {
+            particles.burst(ParticleEffect::Sparks, moved.x, moved.y, z[i], 5, -velX[i], -velY[i]);
+            remove(i);
+            continue;
+        }
+
+        life[i] -= dt;
+        if (life[i] <= 0.0f) {
+            remove(i);
+            continue;
+        }
+
+        i++;
+    }
+}
+
+void ProjectileManager::render(uint32_t* pixels, int screenW, int screenH, const Player& player,
+                               const float* zBuffer, const float* colWallTop) const
+{
+    if (count == 0)
+        return;
+
+    // Camera vectors
+    float dirX = std::cos(player.angle);
+    float dirY = std::sin(player.angle);
+    float planeX = -dirY * 0.66f;
+    float planeY = dirX * 0.66f;
+
+    float invDet = 1.0f / (planeX * dirY - dirX * planeY);
+    float half = SPRITE_SIZE * 0.5f;
+
+    // Same-looking glows, overlap order does not matter so no depth sort
+    for (int i = 0; i < count; i++) {
+        float px = prevX[i] + (x[i] - prevX[i]) * viewAlpha;
+        float py = prevY[i] + (y[i] - prevY[i]) * viewAlpha;
+
+        float dx = px - player.x;
+        float dy = py - player.y;
+
+        // Transform to camera space
+        float transformX = invDet * ( dirY * dx - dirX * dy);
+        float transformY = invDet * (-planeY * dx + planeX * dy);
+
+        if (transformY <= 0.05f) continue; // behind camera
+
+        int screenX = int((screenW / 2.0f) * (1 + transformX / transformY));
+        int spriteH = std::max(1, int(screenH / transformY * SPRITE_SIZE));
+
+        int drawStartY = int(screenH / 2 - (z[i] + half - player.z) / transformY * screenH);
+        int drawEndY = drawStartY + spriteH;
+        int drawStartX = screenX - spriteH / 2;
+        int drawEndX = drawStartX + spriteH;
+
+        int x0 = std::max(0, drawStartX);
+        int x1 = std::min(screenW, drawEndX);
+        int y0 = std::max(0, drawStartY);
+        int y1 = std::min(screenH, drawEndY);
+        if (x0 >= x1 || y0 >= y1) continue;
+
+        for (int sx = x0; sx < x1; sx++) {
+            // Behind a wall, only the part above its top shows
+            int clipEnd = y1;
+            if (zBuffer[sx] < transformY)
+                clipEnd = std::min(y1, int(std::ceil(colWallTop[sx])));
+
+            int srcX = (sx - drawStartX) * spriteSize / spriteH;
+            for (int sy = y0; sy < clipEnd; sy++) {
+                int srcY = (sy - drawStartY) * spriteSize / spriteH;
+                uint32_t color = sprite[srcY * spriteSize + srcX];
+                if ((color >> 24) == 0) continue;
+                pixels[sy * screenW + sx] = color;
+            }
+        }
+    }
+}
@@ -0,0 +1,59 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "Map.h"
+#include "ParticleSystem.h"
+
+class Player;
+
+// Enemy projectiles. A fixed pool of CAPACITY kept as struct-of-arrays with
+// the live shots packed at the front, so firing never allocates and a tick
+// is one pass over plain arrays. Walls are hit through Collision, the player
+// by a swept circle test over the same move.
+class ProjectileManager {
+public:
+    static constexpr int CAPACITY = 1024;
+
+    static constexpr float RADIUS = 0.08f;
+    static constexpr float SPEED = 7.0f;        // tiles per second
+    static constexpr float LIFETIME = 3.0f;     // seconds before a miss fizzles out
+    static constexpr float SPRITE_SIZE = 0.18f; // world units
+
+    ProjectileManager();
+
+    // dirX/dirY must be unit length. False (shot dropped) when the pool is full.
+    bool spawn(float x, float y, float z, float dirX, float dirY,
+               int damage, float shieldMultiplier);
+
+    // One simulation tick: move, then remove shots that hit a wall (with a
+    // puff of sparks) or the player
+    void update(float dt, const Map& map, Player& player, ParticleSystem& particles);
+
+    // Billboards clipped against the walls like pickups
+    void render(uint32_t* pixels, int screenW, int screenH, const Player& player,
+                const float* zBuffer, const float* colWallTop) const;
+
+    void clear() { count = 0; }
+    int activeCount() const { return count; }
+
+    // Where between the last two ticks to draw, set by GameSession for the world draw
+    float viewAlpha = 1.0f;
+
+private:
+    int count = 0;
+
+    // [0, count) are live
+    std::vector<float> x, y, z;
+    std::vector<float> prevX, prevY;
+    std::vector<float> velX, velY;
+    std::vector<float> life;
+    std::vector<int> damage;
+    std::vector<float> shieldMultiplier;
+
+    // Procedural glow, there is no projectile art
+    int spriteSize = 0;
+    std::vector<uint32_t> sprite;
+
+    // Swap the last live shot into i
+    void remove(int i);
+};
@@ -80,7 +80,7 @@ void Raycaster::render(uint32_t* pixels, int screenW, int screenH,
             if (side == 0) { curSideDistX += deltaDistX; curX += stepX; }
             else           { curSideDistY += deltaDistY; curY += stepY; }
 
-            if (curX < 0 || curX >= Map::SIZE || curY < 0 || curY >= Map::SIZE) break;
+            if (!map.inBounds(curX, curY)) break;
 
             const Map::Cell& cell = map.get(curX, curY);
 
@@ -0,0 +1,75 @@
+#include "SpatialGrid.h"
+#include <algorithm>
+
+void SpatialGrid::init(int w, int h, int capacity) {
+    width = w;
+    height = h;
+
+    cellHead.assign(width * height, -1);
+    next.assign(capacity, -1);
+    prev.assign(capacity, -1);
+    cellOf.assign(capacity, -1);
+}
+
+void SpatialGrid::clear() {
+    std::fill(cellHead.begin(), cellHead.end(), -1);
+    std::fill(next.begin(), next.end(), -1);
+    std::fill(prev.begin(), prev.end(), -1);
+    std::fill(cellOf.begin(), cellOf.end(), -1);
+}
+
+void SpatialGrid::link(int id, int cell) {
+    int head = cellHead[cell];
+
+    prev[id] = -1;
+    next[id] = head;
+    if (head != -1)
+        prev[head] = id;
+
+    cellHead[cell] = id;
+    cellOf[id] = cell;
+}
+
+void SpatialGrid::unlink(int id) {
+    int cell = cellOf[id];
+
+    if (prev[id] != -1)
+        next[prev[id]] = next[id];
+    else
+        cellHead[cell] = next[id];
+
+    if (next[id] != -1)
+        prev[next[id]] = prev[id];
+
+    next[id] = -1;
+    prev[id] = -1;
+    cellOf[id] = -1;
+}
+
+void SpatialGrid::insert(int id, float x, float y) {
+    if (id < 0 || id >= (int)cellOf.size())
+        return;
+
+    if (cellOf[id] >= 0)
+        unlink(id);
+
+    link(id, cellIndex(x, y));
+}
+
+void SpatialGrid::move(int id, float x, float y) {
+    if (!contains(id))
+        return;
+
+    // Same tile, nothing to relink
+    int cell = cellIndex(x, y);
+    if (cell == cellOf[id])
+        return;
+
+    unlink(id);
+    link(id, cell);
+}
+
+void SpatialGrid::remove(int id) {
+    if (contains(id))
+        unlink(id);
+}
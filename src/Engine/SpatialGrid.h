@@ -0,0 +1,52 @@
+#pragma once
+#include <vector>
+#include <cmath>
+
+// Uniform grid with one cell per map tile. Each entity id sits in the cell
+// under its position, linked through flat next/prev arrays, so moving within
+// a tile is free and crossing a tile is an O(1) relink.
+class SpatialGrid {
+public:
+    void init(int width, int height, int capacity);
+    void clear();
+
+    void insert(int id, float x, float y);
+    void move(int id, float x, float y);
+    void remove(int id);
+    bool contains(int id) const { return id >= 0 && id < (int)cellOf.size() && cellOf[id] >= 0; }
+
+    // Calls fn(id) for every id in the tiles touched by the square of
+    // half-size r around (x, y). Candidates only, the caller does the exact test.
+    template <typename Fn>
+    void forEachNear(float x, float y, float r, Fn&& fn) const {
+        int x0 = clampX((int)std::floor(x - r));
+        int x1 = clampX((int)std::floor(x + r));
+        int y0 = clampY((int)std::floor(y - r));
+        int y1 = clampY((int)std::floor(y + r));
+
+        for (int cy = y0; cy <= y1; cy++) {
+            for (int cx = x0; cx <= x1; cx++) {
+                for (int id = cellHead[cy * width + cx]; id != -1; id = next[id])
+                    fn(id);
+            }
+        }
+    }
+
+private:
+    int width = 0;
+    int height = 0;
+
+    std::vector<int> cellHead; // first id in each cell, -1 when empty
+    std::vector<int> next;     // per id links inside its cell
+    std::vector<int> prev;
+    std::vector<int> cellOf;   // cell per id, -1 when not in the grid
+
+    int clampX(int x) const { return x < 0 ? 0 : (x >= width ? width - 1 : x); }
+    int clampY(int y) const { return y < 0 ? 0 : (y >= height ? height - 1 : y); }
+    int cellIndex(float x, float y) const {
+        return clampY((int)std::floor(y)) * width + clampX((int)std::floor(x));
+    }
+
+    void link(int id, int cell);
+    void unlink(int id);
+};
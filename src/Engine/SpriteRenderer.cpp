@@ -12,26 +12,37 @@ void SpriteRenderer::renderEnemies(
     Map& map,
     float colWallTop[]
 ) {
-    struct DrawInfo {
-        Enemy* enemy;
-        float dist;
-    };
-
-    DrawInfo drawList[EnemyManager::MAX_ENEMIES];
-    int count = 0;
-
-    // Collect active enemies and compute distance
-    for (Enemy& e : manager.enemies) {
-        if (!e.active) continue;
-        float dx = e.x - player.x;
-        float dy = e.y - player.y;
-        drawList[count++] = { &e, std::sqrt(dx*dx + dy*dy) };
+    const EnemyHot& hot = manager.hot;
+    const CorpseList& corpses = manager.corpses;
+    const std::vector<int>& active = manager.activeIndices();
+
+    drawList.clear();
+    drawList.reserve(active.size() + corpses.size());
+
+    // Collect active enemies and compute distance from the hot arrays
+    for (int slot : active) {
+        const SpriteFrame* frame = manager.enemies[slot].sprite;
+        if (!frame || frame->pixels.empty()) continue;
+
+        float dx = hot.x[slot] - player.x;
+        float dy = hot.y[slot] - player.y;
+        drawList.push_back({ hot.x[slot], hot.y[slot], hot.z[slot], hot.height[slot], frame,
+                             std::sqrt(dx*dx + dy*dy) });
     }
 
+    // Corpses never move, only their distance changes
+    for (int i = 0; i < corpses.size(); i++) {
+        float dx = corpses.x[i] - player.x;
+        float dy = corpses.y[i] - player.y;
+        drawList.push_back({ corpses.x[i], corpses.y[i], corpses.z[i], corpses.height[i],
+                             corpses.frame[i], std::sqrt(dx*dx + dy*dy) });
+    }
+
+    int count = (int)drawList.size();
     if (count == 0) return;
 
     // Sort back-to-front
-    std::sort(drawList, drawList + count,
+    std::sort(drawList.begin(), drawList.end(),
         [](const DrawInfo& a, const DrawInfo& b) { return a.dist > b.dist; }
     );
 
@@ -42,13 +53,15 @@ void SpriteRenderer::renderEnemies(
     float planeY = dirX * 0.66f;
 
     for (int i = 0; i < count; i++) {
-        Enemy* e = drawList[i].enemy;
-        std::vector<uint32_t>& framePixels = e->spritePixels;
-        int frameW = e->spriteW;
-        int frameH = e->spriteH;
+        const DrawInfo& d = drawList[i];
+        const SpriteFrame* frame = d.frame;
 
-        float dx = e->x - player.x;
-        float dy = e->y - player.y;
+        const std::vector<uint32_t>& framePixels = frame->pixels;
+        int frameW = frame->w;
+        int frameH = frame->h;
+
+        float dx = d.x - player.x;
+        float dy = d.y - player.y;
 
         // Transform to camera space
         float invDet = 1.0f / (planeX * dirY - dirX * planeY);
@@ -61,11 +74,14 @@ void SpriteRenderer::renderEnemies(
         int screenX = int((screenW / 2.0f) * (1 + transformX / transformY));
 
         // Vertical scaling with aspect ratio
-        int spriteH = std::max(1, int(screenH / transformY * e->height));
+        float enemyZ = d.z;
+        float enemyHeight = d.height;
+
+        int spriteH = std::max(1, int(screenH / transformY * enemyHeight));
         int spriteW = std::max(1, int(spriteH * (float(frameW) / float(frameH))));
 
-        float enemyBottom = e->z - player.z;
-        float enemyTop = e->z + e->height - player.z;
+        float enemyBottom = enemyZ - player.z;
+        float enemyTop = enemyZ + enemyHeight - player.z;
 
         int drawStartY = int(screenH / 2 - enemyTop / transformY * screenH);
         int drawEndY = int(screenH / 2 - enemyBottom / transformY * screenH);
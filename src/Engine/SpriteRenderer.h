@@ -17,5 +17,17 @@ public:
         float colWallTop[]
     );
     bool isSpriteOccludedByWall(const Player& player, const Enemy& e, const Map& map);
+
+private:
+    // Live enemies and corpses sorted together, so each carries what to draw
+    struct DrawInfo {
+        float x, y, z;
+        float height;
+        const SpriteFrame* frame;
+        float dist;
+    };
+
+    // Reused every frame
+    std::vector<DrawInfo> drawList;
 };
 
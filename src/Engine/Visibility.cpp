@@ -0,0 +1,201 @@
+#include "Visibility.h"
+#include "Map.h"
+#include <algorithm>
+#include <cmath>
+
+uint8_t Visibility::levelOf(const Map& map, int x, int y) const {
+    if (map.typeFast(x, y) != Map::TileType::Wall)
+        return 0;
+
+    float h = map.heightFast(x, y);
+
+    uint8_t level = 0;
+    while (level < HEIGHT_CLASSES && h >= CLASS_HEIGHT[level])
+        level++;
+    return level;
+}
+
+// Bit of b in a's window, the caller keeps b within REACH of a
+int Visibility::windowBit(int a, int b) const {
+    int dx = (b % width) - (a % width);
+    int dy = (b / width) - (a / width);
+    return (dy + REACH) * WINDOW + (dx + REACH);
+}
+
+void Visibility::setPair(int a, int b, int maxLevel) {
+    // The window is symmetric, b's bit for a mirrors a's bit for b
+    int bitAB = windowBit(a, b);
+    int bitBA = WINDOW_BITS - 1 - bitAB;
+
+    for (int k = 0; k < HEIGHT_CLASSES; k++) {
+        bool open = maxLevel <= k;
+
+        uint64_t* tiles = bits[k].data();
+        uint64_t maskAB = 1ull << (bitAB & 63);
+        uint64_t maskBA = 1ull << (bitBA & 63);
+        uint64_t& wAB = tiles[a * TILE_WORDS + (bitAB >> 6)];
+        uint64_t& wBA = tiles[b * TILE_WORDS + (bitBA >> 6)];
+
+        if (open) { wAB |= maskAB; wBA |= maskBA; }
+        else      { wAB &= ~maskAB; wBA &= ~maskBA; }
+    }
+}
+
+// Same 0.1 step march the old per-frame check used, from centre to centre,
+// keeping the tallest class crossed. Traced once, stored both ways.
+void Visibility::tracePair(int a, int b) {
+    float ax = (a % width) + 0.5f;
+    float ay = (a / width) + 0.5f;
+    float bx = (b % width) + 0.5f;
+    float by = (b / width) + 0.5f;
+
+    float dx = bx - ax;
+    float dy = by - ay;
+    float dist = std::sqrt(dx*dx + dy*dy);
+
+    int steps = int(dist / 0.1f);
+    int maxLevel = 0;
+
+    if (steps > 0) {
+        float incX = dx / steps;
+        float incY = dy / steps;
+        float sx = ax;
+        float sy = ay;
+
+        for (int i = 0; i < steps && maxLevel < HEIGHT_CLASSES; i++) {
+            sx += incX;
+            sy += incY;
+            maxLevel = std::max<int>(maxLevel, tileLevel[int(sy) * width + int(sx)]);
+        }
+    }
+
+    setPair(a, b, maxLevel);
+}
+
+void Visibility::build(const Map& map) {
+    width = map.width;
+    height = map.height;
+
+    int tileCount = width * height;
+    for (auto& b : bits)
+        b.assign((size_t)tileCount * TILE_WORDS, 0);
+
+    tileLevel.resize(tileCount);
+    for (int y = 0; y < height; y++)
+        for (int x = 0; x < width; x++)
+            tileLevel[y * width + x] = levelOf(map, x, y);
+
+    dirty.clear();
+
+    const float maxDistSq = MAX_DISTANCE * MAX_DISTANCE;
+
+    for (int ay = 0; ay < height; ay++) {
+        for (int ax = 0; ax < width; ax++) {
+            int a = ay * width + ax;
+
+            // Each pair once, b at or after a in row-major order
+            int y1 = std::min(height - 1, ay + REACH);
+            for (int by = ay; by <= y1; by++) {
+                int x0 = (by == ay) ? ax : std::max(0, ax - REACH);
+                int x1 = std::min(width - 1, ax + REACH);
+
+                for (int bx = x0; bx <= x1; bx++) {
+                    int dx = bx - ax;
+                    int dy = by - ay;
+                    if (dx*dx + dy*dy > maxDistSq) continue;
+
+                    tracePair(a, by * width + bx);
+                }
+            }
+        }
+    }
+}
+
+void Visibility::markDirty(int x, int y) {
+    if (x < 0 || y < 0 || x >= width || y >= height)
+        return;
+    dirty.push_back(y * width + x);
+}
+
+void Visibility::refresh(const Map& map) {
+    if (dirty.empty())
+        return;
+
+    // Only class changes matter, most animation steps change nothing here
+    std::vector<int> changed;
+    for (int t : dirty) {
+        uint8_t level = levelOf(map, t % width, t / width);
+        if (level != tileLevel[t]) {
+            tileLevel[t] = level;
+            changed.push_back(t);
+        }
+    }
+    dirty.clear();
+
+    const float maxDistSq = MAX_DISTANCE * MAX_DISTANCE;
+    const int reach = (int)std::ceil(MAX_DISTANCE);
+
+    for (int t : changed) {
+        float tx = (t % width) + 0.5f;
+        float ty = (t / width) + 0.5f;
+
+        int x0 = std::max(0, int(tx) - reach), x1 = std::min(width - 1, int(tx) + reach);
+        int y0 = std::max(0, int(ty) - reach), y1 = std::min(height - 1, int(ty) + reach);
+
+        // Both ends of any ray through t lie within range of t, so only
+        // those rows and columns are revisited
+        for (int ay = y0; ay <= y1; ay++) {
+            for (int ax = x0; ax <= x1; ax++) {
+                int a = ay * width + ax;
+
+                for (int by = y0; by <= y1; by++) {
+                    for (int bx = x0; bx <= x1; bx++) {
+                        int b = by * width + bx;
+                        if (b < a) continue;
+
+                        float sx = float(bx - ax);
+                        float sy = float(by - ay);
+                        float lenSq = sx*sx + sy*sy;
+                        if (lenSq > maxDistSq) continue;
+
+                        // Distance from t's centre to the segment a-b
+                        float px = tx - (ax + 0.5f);
+                        float py = ty - (ay + 0.5f);
+                        float u = lenSq > 0.0f ? (px*sx + py*sy) / lenSq : 0.0f;
+                        u = std::clamp(u, 0.0f, 1.0f);
+                        float ex = px - sx * u;
+                        float ey = py - sy * u;
+
+                        // Samples can land in any tile within half a diagonal of the line
+                        if (ex*ex + ey*ey > 0.75f * 0.75f) continue;
+
+                        tracePair(a, b);
+                    }
+                }
+            }
+        }
+    }
+}
+
+bool Visibility::visible(int ax, int ay, int bx, int by, float blockingHeight) const {
+    if (width == 0)
+        return true;
+
+    ax = std::clamp(ax, 0, width - 1);
+    ay = std::clamp(ay, 0, height - 1);
+    bx = std::clamp(bx, 0, width - 1);
+    by = std::clamp(by, 0, height - 1);
+
+    // Outside the window is further than MAX_DISTANCE, never visible
+    if (std::abs(bx - ax) > REACH || std::abs(by - ay) > REACH)
+        return false;
+
+    // Tallest class not above the requested height, errs on the blocking side
+    int k = 0;
+    while (k + 1 < HEIGHT_CLASSES && CLASS_HEIGHT[k + 1] <= blockingHeight)
+        k++;
+
+    int a = ay * width + ax;
+    int bit = (by - ay + REACH) * WINDOW + (bx - ax + REACH);
+    return (bits[k][a * TILE_WORDS + (bit >> 6)] >> (bit & 63)) & 1ull;
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+
+class Map;
+
+// Precomputed tile-to-tile line of sight. For each blocking height class,
+// every tile keeps a bit per tile in the window of MAX_DISTANCE around it,
+// set when no wall tall enough for that class sits on the ray between the
+// two tile centres. Memory grows with map area, not area squared.
+class Visibility {
+public:
+    static constexpr int HEIGHT_CLASSES = 4;
+
+    // A wall blocks class k when its height >= CLASS_HEIGHT[k]
+    static constexpr float CLASS_HEIGHT[HEIGHT_CLASSES] = { 0.25f, 0.5f, 0.75f, 1.0f };
+
+    // Pairs further apart than this are never marked visible
+    static constexpr float MAX_DISTANCE = 11.5f;
+
+    static constexpr int REACH = 11; // whole tiles within MAX_DISTANCE on one axis
+    static constexpr int WINDOW = 2 * REACH + 1;
+    static constexpr int WINDOW_BITS = WINDOW * WINDOW;
+    static constexpr int TILE_WORDS = (WINDOW_BITS + 63) / 64;
+
+    // Full rebuild, run once when the map is built
+    void build(const Map& map);
+
+    // Note a tile whose height changed, picked up by the next refresh()
+    void markDirty(int x, int y);
+
+    // Re-trace only the rays crossing dirty tiles whose height class changed
+    void refresh(const Map& map);
+
+    bool visible(int ax, int ay, int bx, int by, float blockingHeight) const;
+
+private:
+    int width = 0;
+    int height = 0;
+
+    std::vector<uint64_t> bits[HEIGHT_CLASSES];
+
+    // Number of classes each tile blocks, 0 for open tiles
+    std::vector<uint8_t> tileLevel;
+    std::vector<int> dirty;
+
+    uint8_t levelOf(const Map& map, int x, int y) const;
+    int windowBit(int a, int b) const;
+    void tracePair(int a, int b);
+    void setPair(int a, int b, int maxLevel);
+};
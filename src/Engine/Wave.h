@@ -0,0 +1,22 @@
+#pragma once
+
+#include <vector>
+#include "Enemy.h"
+
+struct Wave {
+    float spawnInterval;
+    std::vector<EnemyType> enemies;
+};
+
+struct WallHeightAnim {
+    int x;
+    int y;
+
+    float startHeight;
+    float targetHeight;
+
+    float progress;   // 0.0, 1.0
+    float speed;      // units per second
+
+    bool finished = false;
+};
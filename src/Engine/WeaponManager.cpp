@@ -6,33 +6,19 @@
 #include <vector>
 #include "../Utils/PathUtils.h"
 
-// Helper function: load PNG via wrapper and create SDL_Texture
-SDL_Texture* LoadTextureFromFile(SDL_Renderer* renderer, const char* path) {
-    // Load surface using wrapper
+// Helper function: load PNG via wrapper into a surface
+static SDL_Surface* LoadSurfaceFromFile(const char* path) {
     std::string fullPath = resolvePath(path);
     SDL_Surface* surface = LoadSurfaceFromPNG(fullPath.c_str());
     if (!surface) {
         std::cerr << "Failed to load image: " << path << "\n";
-        return nullptr;
     }
-
-    // Create SDL_Texture from surface
-    SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
-    if (!texture) {
-        std::cerr << "Failed to create texture for: " << path
-                  << " | " << SDL_GetError() << "\n";
-    }
-
-    // Free surface (also frees underlying pixel buffer)
-    FreeSurface(surface);
-
-    return texture;
+    return surface;
 }
 
-bool WeaponManager::loadAssets(SDL_Renderer* renderer) {
+bool WeaponManager::decodeAssets() {
+    if (decoded) return true;
 
-    // Load pistol frames
-    Animation pistolAnim;
     const char* pistolPaths[] = {
         "Assets/Pistol0.png", "Assets/Pistol1.png", "Assets/Pistol2.png",
         "Assets/Pistol3.png", "Assets/Pistol4.png", "Assets/Pistol5.png",
@@ -41,15 +27,14 @@ bool WeaponManager::loadAssets(SDL_Renderer* renderer) {
         "Assets/Pistol12.png"
     };
     for (const char* path : pistolPaths) {
-        SDL_Texture* tex = LoadTextureFromFile(renderer, path);
-        if (!tex) return false;
-        pistolAnim.frames.push_back(tex);
+        SDL_Surface* surf = LoadSurfaceFromFile(path);
+        if (!surf) {
+            freeSurfaces();
+            return false;
+        }
+        decodedFrames[WeaponType::Pistol].push_back(surf);
     }
-    pistolAnim.frameTime = 0.09f;
-    animations[WeaponType::Pistol] = pistolAnim;
 
-    // Load shotgun frames
-    Animation shotgunAnim;
     const char* shotgunPaths[] = {
         "Assets/Shotgun0.png", "Assets/Shotgun1.png", "Assets/Shotgun2.png",
         "Assets/Shotgun3.png", "Assets/Shotgun4.png", "Assets/Shotgun5.png",
@@ -57,15 +42,14 @@ bool WeaponManager::loadAssets(SDL_Renderer* renderer) {
         "Assets/Shotgun9.png", "Assets/Shotgun10.png"
     };
     for (const char* path : shotgunPaths) {
-        SDL_Texture* tex = LoadTextureFromFile(renderer, path);
-        if (!tex) return false;
-        shotgunAnim.frames.push_back(tex);
+        SDL_Surface* surf = LoadSurfaceFromFile(path);
+        if (!surf) {
+            freeSurfaces();
+            return false;
+        }
+        decodedFrames[WeaponType::Shotgun].push_back(surf);
     }
-    shotgunAnim.frameTime = 0.14f;
-    animations[WeaponType::Shotgun] = shotgunAnim;
 
-    // Load MG frames
-    Animation mgAnim;
     const char* mgPaths[] = {
         "Assets/Mg0.png", "Assets/Mg1.png", "Assets/Mg2.png", "Assets/Mg3.png",
         "Assets/Mg4.png", "Assets/Mg5.png", "Assets/Mg6.png", "Assets/Mg7.png",
@@ -73,16 +57,88 @@ bool WeaponManager::loadAssets(SDL_Renderer* renderer) {
         "Assets/Mg12.png", "Assets/Mg13.png", "Assets/Mg14.png", "Assets/Mg15.png"
     };
     for (const char* path : mgPaths) {
-        SDL_Texture* tex = LoadTextureFromFile(renderer, path);
-        if (!tex) return false;
-        mgAnim.frames.push_back(tex);
+        SDL_Surface* surf = LoadSurfaceFromFile(path);
+        if (!surf) {
+            freeSurfaces();
+            return false;
+        }
+        decodedFrames[WeaponType::Mg].push_back(surf);
     }
-    mgAnim.frameTime = 0.01f;
-    animations[WeaponType::Mg] = mgAnim;
 
+    decoded = true;
     return true;
 }
 
+void WeaponManager::freeSurfaces() {
+    for (auto& [weapon, surfaces] : decodedFrames) {
+        for (SDL_Surface* surf : surfaces)
+            FreeSurface(surf);
+    }
+
+    decodedFrames.clear();
+    decoded = false;
+}
+
+bool WeaponManager::loadAssets(SDL_Renderer* renderer) {
+    if (!decoded && !decodeAssets())
+        return false;  // decodeAssets() already cleaned up
+
+    bool ok = true;
+
+    for (auto& [weapon, surfaces] : decodedFrames) {
+        Animation anim;
+        for (SDL_Surface* surf : surfaces) {
+            // Create SDL_Texture from surface
+            SDL_Texture* tex = SDL_CreateTextureFromSurface(renderer, surf);
+            if (!tex) {
+                std::cerr << "Failed to create weapon texture | " << SDL_GetError() << "\n";
+                ok = false;
+            }
+            else {
+                anim.frames.push_back(tex);
+            }
+
+            // Free surface (also frees underlying pixel buffer)
+            FreeSurface(surf);
+        }
+
+        if (weapon == WeaponType::Pistol) anim.frameTime = 0.09f;
+        else if (weapon == WeaponType::Shotgun) anim.frameTime = 0.14f;
+        else if (weapon == WeaponType::Mg) anim.frameTime = 0.01f;
+
+        animations[weapon] = anim;
+    }
+
+    decodedFrames.clear();
+    decoded = false;
+
+    return ok;
+}
+
+void WeaponManager::reset() {
+    currentWeapon = WeaponType::None;
+    pendingWeapon = WeaponType::None;
+
+    swapState = SwapState::Idle;
+    swapOffsetY = 0.0f;
+
+    bobTimer = 0.0f;
+    bobAmount = 0.0f;
+
+    for (auto& [weapon, anim] : animations) {
+        anim.timer = 0.0f;
+        anim.current = 0;
+        anim.playing = false;
+        anim.startFrame = 0;
+        anim.endFrame = -1;
+    }
+
+    // Mg frame time is changed by shoot/reload, restore the loaded value
+    auto mg = animations.find(WeaponType::Mg);
+    if (mg != animations.end())
+        mg->second.frameTime = 0.01f;
+}
+
 void WeaponManager::startSwap(WeaponType newWeapon) {
     if (swapState != SwapState::Idle)
         return;
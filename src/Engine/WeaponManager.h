@@ -14,11 +14,21 @@ enum class SwapState {
 
 class WeaponManager {
 public:
+    WeaponManager() = default;
+    ~WeaponManager() { freeSurfaces(); }
+
+    // Owns decoded surfaces until loadAssets() uploads them
+    WeaponManager(const WeaponManager&) = delete;
+    WeaponManager& operator=(const WeaponManager&) = delete;
 
     // Bobbing vars
     float bobTimer = 0.0f;
     float bobAmount = 0.0f;   // final computed sway amount
 
+    // Decode weapon frames into surfaces (no renderer needed, safe off the main thread)
+    bool decodeAssets();
+
+    // Upload decoded frames as textures (main thread). Decodes first if needed.
     bool loadAssets(SDL_Renderer* renderer);
     void update(float delta, const Player& player);
     SDL_Texture* getCurrentFrame(WeaponType weapon);
@@ -29,14 +39,17 @@ public:
 
     void startSwap(WeaponType newWeapon);
 
+    // Reset animation / swap state for a new run (textures stay loaded)
+    void reset();
+
     int getDrawOffsetY() const;
 
     //WeaponType getCurrentWeapon() const { return currentWeapon; }
 
 private:
 
-    WeaponType currentWeapon;
-    WeaponType pendingWeapon;
+    WeaponType currentWeapon = WeaponType::None;
+    WeaponType pendingWeapon = WeaponType::None;
 
     SwapState swapState = SwapState::Idle;
 
@@ -55,4 +68,11 @@ private:
     };
 
     std::map<WeaponType, Animation> animations;
+
+    // Frames decoded by decodeAssets(), waiting for loadAssets() to upload them
+    std::map<WeaponType, std::vector<SDL_Surface*>> decodedFrames;
+    bool decoded = false;
+
+    // Drop whatever is still decoded, after a failure or when never uploaded
+    void freeSurfaces();
 };
@@ -0,0 +1,104 @@
+#include "WorkerPool.h"
+#include <algorithm>
+
+WorkerPool::WorkerPool(int threadCount) {
+    if (threadCount <= 0)
+        threadCount = (int)std::thread::hardware_concurrency() - 1;
+
+    threadCount = std::clamp(threadCount, 0, 15);
+
+    threads.reserve(threadCount);
+    for (int i = 0; i < threadCount; i++)
+        threads.emplace_back(&WorkerPool::workerLoop, this);
+}
+
+WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        quit = true;
+    }
+    wake.notify_all();
+
+    for (auto& t : threads)
+        t.join();
+}
+
+void WorkerPool::run(int count, const std::function<void(int)>& fn) {
+    if (count <= 0)
+        return;
+
+    // Nothing to share, skip the handoff entirely
+    if (threads.empty() || count == 1) {
+        for (int i = 0; i < count; i++)
+            fn(i);
+        return;
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+
+        // A worker that woke late for the previous job may still hold it
+        done.wait(lock, [&] { return busyWorkers == 0; });
+
+        job = &fn;
+        jobCount = count;
+        nextJob.store(0, std::memory_order_relaxed);
+        remaining.store(count, std::memory_order_relaxed);
+        generation++;
+    }
+    wake.notify_all();
+
+    drain(fn, count);
+
+    std::unique_lock<std::mutex> lock(mutex);
+    done.wait(lock, [&] {
+        return remaining.load(std::memory_order_acquire) == 0 && busyWorkers == 0;
+    });
+    job = nullptr;
+}
+
+void WorkerPool::drain(const std::function<void(int)>& fn, int count) {
+    for (;;) {
+        int i = nextJob.fetch_add(1, std::memory_order_relaxed);
+        if (i >= count)
+            break;
+
+        fn(i);
+
+        if (remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            std::lock_guard<std::mutex> lock(mutex);
+            done.notify_all();
+        }
+    }
+}
+
+void WorkerPool::workerLoop() {
+    uint64_t seen = 0;
+
+    for (;;) {
+        const std::function<void(int)>* fn;
+        int count;
+
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [&] { return quit || generation != seen; });
+            if (quit)
+                return;
+
+            seen = generation;
+            fn = job;
+            count = jobCount;
+            if (!fn)
+                continue;
+            busyWorkers++;
+        }
+
+        drain(*fn, count);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            busyWorkers--;
+        }
+        done.notify_all();
+    }
+}
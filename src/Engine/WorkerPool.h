@@ -0,0 +1,44 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Small persistent thread pool for per-frame data-parallel work. run()
+// hands out job indices to the workers and the calling thread, and only
+// returns once every index is done, so callers never see a job in flight.
+class WorkerPool {
+public:
+    // 0 picks one worker per hardware thread, minus the caller
+    explicit WorkerPool(int threads = 0);
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    // Threads that take part in run(), including the caller
+    int concurrency() const { return (int)threads.size() + 1; }
+
+    void run(int jobCount, const std::function<void(int)>& job);
+
+private:
+    std::vector<std::thread> threads;
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+
+    const std::function<void(int)>* job = nullptr;
+    int jobCount = 0;
+    std::atomic<int> nextJob{ 0 };
+    std::atomic<int> remaining{ 0 };
+    int busyWorkers = 0;
+    uint64_t generation = 0;
+    bool quit = false;
+
+    void workerLoop();
+    void drain(const std::function<void(int)>& fn, int count);
+};
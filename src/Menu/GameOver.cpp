@@ -71,6 +71,11 @@ void GameOver::handleInput(SDL_Event& e, GameState& gameState, bool& running)
                 gameState = GameState::MainMenu;
                 break;
 
+            // Retry from the start of the current wave
+            case SDLK_r:
+                gameState = GameState::Playing;
+                break;
+
             case SDLK_ESCAPE:
                 running = false;
                 break;
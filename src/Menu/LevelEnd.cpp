@@ -193,7 +193,7 @@ void LevelEnd::update(float dt, GameState& gameState, AudioManager& audio)
     {
         if (!sliding) {
             sliding = true;
-            audio.playSFX("lvlEnd_wordsCollide");
+            audio.playSFX(SfxId::LvlEndWordsCollide);
         }
     }
 
@@ -145,17 +145,17 @@ void MainMenu::handleInput(const SDL_Event& e, GameState& gs,
         {
             case SDLK_UP:
                 selectedIndexOptions = (selectedIndexOptions - 1 + OPTIONS_COUNT) % OPTIONS_COUNT;
-                audio.playSFX("menu_up");
+                audio.playSFX(SfxId::MenuUp);
                 break;
     
             case SDLK_DOWN:
                 selectedIndexOptions = (selectedIndexOptions + 1) % OPTIONS_COUNT;
-                audio.playSFX("menu_up");
+                audio.playSFX(SfxId::MenuUp);
                 break;
     
             case SDLK_RETURN:
                 activateSelected(gs, running, mRunning, difficulty);
-                audio.playSFX("menu_enter");
+                audio.playSFX(SfxId::MenuEnter);
                 break;
     
             default:
@@ -167,17 +167,17 @@ void MainMenu::handleInput(const SDL_Event& e, GameState& gs,
         {
             case SDLK_UP:
                 selectedIndex = (selectedIndex - 1 + MENU_COUNT) % MENU_COUNT;
-                audio.playSFX("menu_up");
+                audio.playSFX(SfxId::MenuUp);
                 break;
 
             case SDLK_DOWN:
                 selectedIndex = (selectedIndex + 1) % MENU_COUNT;
-                audio.playSFX("menu_up");
+                audio.playSFX(SfxId::MenuUp);
                 break;
 
             case SDLK_RETURN:
                 activateSelected(gs, running, mRunning, difficulty);
-                audio.playSFX("menu_enter");
+                audio.playSFX(SfxId::MenuEnter);
                 break;
 
             default:
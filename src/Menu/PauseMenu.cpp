@@ -100,17 +100,17 @@ void PauseMenu::handleInput(const SDL_Event& e, GameState& gs, bool& running, Au
     {
         case SDLK_UP:
             selectedIndex = (selectedIndex - 1 + MENU_COUNT) % MENU_COUNT;
-            audio.playSFX("menu_up");
+            audio.playSFX(SfxId::MenuUp);
             break;
 
         case SDLK_DOWN:
             selectedIndex = (selectedIndex + 1) % MENU_COUNT;
-            audio.playSFX("menu_up");
+            audio.playSFX(SfxId::MenuUp);
             break;
 
         case SDLK_RETURN:
             activateSelected(gs, running);
-            audio.playSFX("menu_enter");
+            audio.playSFX(SfxId::MenuEnter);
             break;
 
         default:
@@ -0,0 +1,36 @@
+// Offline level compiler: bakes a .lvl source into the binary level the
+// game loads, so no geometry processing happens at startup.
+//
+//   LevelCompiler <source.lvl> <output.bin>
+
+#include <iostream>
+#include "../Engine/LevelFile.h"
+#include "../Engine/Map.h"
+
+int main(int argc, char** argv) {
+    if (argc != 3) {
+        std::cerr << "usage: " << argv[0] << " <source.lvl> <output.bin>" << std::endl;
+        return 1;
+    }
+
+    Map map;
+    if (!map.loadFromFile(argv[1], false))
+        return 1;
+
+    LevelData level;
+    compileLevel(map, level);
+
+    // Lets the game spot a baked file that is older than its source
+    if (!hashLevelSource(argv[1], level.sourceHash))
+        return 1;
+
+    if (!writeLevelFile(argv[2], level))
+        return 1;
+
+    std::cout << argv[2] << ": " << level.width << "x" << level.height << ", "
+              << level.segments.size() << " segments, "
+              << level.bspNodes.size() << " BSP nodes, "
+              << level.spawnPoints.size() << " spawn points, "
+              << level.groups.size() << " tile groups" << std::endl;
+    return 0;
+}
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include "SfxId.h"
+
+enum class AudioCommandType : uint8_t {
+    PlaySFX,
+    PlaySFXAt,
+    StopSFX,
+    SetSFXVolume,
+    SetListener
+};
+
+// Small POD message, copied by value into the queue
+struct AudioCommand {
+    AudioCommandType type = AudioCommandType::PlaySFX;
+    SfxId id = SfxId::Count;
+    float x = 0.0f;        // PlaySFXAt: source pos, SetListener: listener pos
+    float y = 0.0f;
+    float value = 1.0f;    // volume, or listener angle for SetListener
+    float priority = 1.0f; // PlaySFXAt only
+};
+
+// Bounded lock-free queue, many producers / one consumer.
+// Each cell carries a sequence number telling producers and the consumer
+// whose turn it is, so neither side ever takes a lock.
+class AudioCommandQueue
+{
+public:
+    static constexpr size_t CAPACITY = 256; // must be a power of two
+
+    AudioCommandQueue()
+    {
+        for (size_t i = 0; i < CAPACITY; i++)
+            cells[i].seq.store(i, std::memory_order_relaxed);
+    }
+
+    // Any thread. Returns false (command dropped) when the queue is full.
+    bool push(const AudioCommand& cmd)
+    {
+        size_t pos = enqueuePos.load(std::memory_order_relaxed);
+
+        for (;;)
+        {
+            Cell& cell = cells[pos & MASK];
+            size_t seq = cell.seq.load(std::memory_order_acquire);
+            intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+
+            if (diff == 0)
+            {
+                // Cell is free for this position, try to claim it
+                if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    cell.cmd = cmd;
+                    cell.seq.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (diff < 0)
+            {
+                return false; // full
+            }
+            else
+            {
+                pos = enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Consumer thread only
+    bool pop(AudioCommand& out)
+    {
+        Cell& cell = cells[dequeuePos & MASK];
+        size_t seq = cell.seq.load(std::memory_order_acquire);
+
+        if ((intptr_t)seq - (intptr_t)(dequeuePos + 1) < 0)
+            return false; // empty, or producer still writing
+
+        out = cell.cmd;
+        cell.seq.store(dequeuePos + CAPACITY, std::memory_order_release);
+        dequeuePos++;
+        return true;
+    }
+
+private:
+    static constexpr size_t MASK = CAPACITY - 1;
+    static_assert((CAPACITY & MASK) == 0, "CAPACITY must be a power of two");
+
+    struct Cell {
+        std::atomic<size_t> seq;
+        AudioCommand cmd;
+    };
+
+    Cell cells[CAPACITY];
+
+    // Keep the producer and consumer counters on separate cache lines
+    alignas(64) std::atomic<size_t> enqueuePos{0};
+    alignas(64) size_t dequeuePos = 0;
+};
@@ -1,6 +1,8 @@
 #define MINIAUDIO_IMPLEMENTATION
 #include "../third_party/miniaudio.h"
 #include "AudioManager.h"
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 #include "../Utils/PathUtils.h"
 
@@ -12,81 +14,480 @@ bool AudioManager::init()
         return false;
     }
     initialized = true;
+
+    // Build the voice pool up front
+    ma_uint32 channels = ma_engine_get_channels(&engine);
+    ma_uint32 sampleRate = ma_engine_get_sample_rate(&engine);
+
+    for (int i = 0; i < MAX_VOICES; i++)
+    {
+        Voice& v = voices[i];
+        ma_audio_buffer_ref_init(ma_format_f32, channels, nullptr, 0, &v.source);
+        v.source.sampleRate = sampleRate;
+
+        if (ma_sound_init_from_data_source(&engine, &v.source,
+                MA_SOUND_FLAG_NO_SPATIALIZATION, nullptr, &v.sound) != MA_SUCCESS)
+        {
+            std::cerr << "Failed to create SFX voice\n";
+
+            // Roll back the voices created so far, SFX stay silent
+            ma_audio_buffer_ref_uninit(&v.source);
+            for (int j = 0; j < i; j++)
+            {
+                ma_sound_uninit(&voices[j].sound);
+                ma_audio_buffer_ref_uninit(&voices[j].source);
+            }
+            return true;
+        }
+    }
+    voicesReady = true;
+
     return true;
 }
 
-void AudioManager::loadSFX(const std::string& name, const std::string& path)
+void AudioManager::loadSFX(SfxId id, const std::string& path, int maxVoices)
 {
-    if (sfx.contains(name))
+    if (!initialized || id == SfxId::Count)
         return;
 
-    ma_sound& sound = sfx[name];
+    SfxBank& bank = banks[static_cast<size_t>(id)];
+    if (bank.pcm)
+        return;
 
     std::string fullPath = resolvePath(path);
 
-    if (ma_sound_init_from_file(
-            &engine,
-            fullPath.c_str(),
-            0,
-            nullptr,
-            nullptr,
-            &sound) != MA_SUCCESS)
+    // Decode straight to the engine format so voices can share one layout
+    ma_decoder_config config = ma_decoder_config_init(
+        ma_format_f32,
+        ma_engine_get_channels(&engine),
+        ma_engine_get_sample_rate(&engine));
+
+    bank.maxVoices = std::max(1, maxVoices);
+
+    if (ma_decode_file(fullPath.c_str(), &config, &bank.frameCount, &bank.pcm) != MA_SUCCESS)
     {
-        std::cerr << "Failed to load SFX: " << fullPath << "\n";
-        sfx.erase(name);
+        std::cerr << "Failed to load SFX " << sfxName(id) << ": " << fullPath << "\n";
+        bank.pcm = nullptr;
+        bank.frameCount = 0;
         return;
     }
 }
 
-void AudioManager::playSFX(const std::string& name, float volume)
+int AudioManager::acquireVoice(int bank)
 {
-    if (!initialized)
+    int activeForBank = 0;
+    int oldestForBank = -1;
+    int oldestAny = 0;
+    int freeVoice = -1;
+
+    for (int i = 0; i < MAX_VOICES; i++)
+    {
+        Voice& v = voices[i];
+
+        if (!ma_sound_is_playing(&v.sound))
+        {
+            if (freeVoice < 0) freeVoice = i;
+            continue;
+        }
+
+        if (v.startedAt < voices[oldestAny].startedAt)
+            oldestAny = i;
+
+        if (v.bank == bank)
+        {
+            activeForBank++;
+            if (oldestForBank < 0 || v.startedAt < voices[oldestForBank].startedAt)
+                oldestForBank = i;
+        }
+    }
+
+    // Per-sound limit reached, steal that sound's oldest voice
+    if (activeForBank >= banks[bank].maxVoices)
+        return oldestForBank;
+
+    if (freeVoice >= 0)
+        return freeVoice;
+
+    // Pool exhausted, steal the oldest voice overall
+    return oldestAny;
+}
+
+void AudioManager::playSFX(SfxId id, float volume)
+{
+    AudioCommand cmd;
+    cmd.type = AudioCommandType::PlaySFX;
+    cmd.id = id;
+    cmd.value = volume;
+    commands.push(cmd); // a full queue just drops the sound
+}
+
+void AudioManager::stopSFX(SfxId id)
+{
+    AudioCommand cmd;
+    cmd.type = AudioCommandType::StopSFX;
+    cmd.id = id;
+    commands.push(cmd);
+}
+
+void AudioManager::setSFXVolume(float volume)
+{
+    AudioCommand cmd;
+    cmd.type = AudioCommandType::SetSFXVolume;
+    cmd.value = volume;
+    commands.push(cmd);
+}
+
+void AudioManager::setListener(float x, float y, float angle)
+{
+    AudioCommand cmd;
+    cmd.type = AudioCommandType::SetListener;
+    cmd.x = x;
+    cmd.y = y;
+    cmd.value = angle;
+    commands.push(cmd);
+}
+
+void AudioManager::playSFXAt(SfxId id, float x, float y, float volume, float priority)
+{
+    AudioCommand cmd;
+    cmd.type = AudioCommandType::PlaySFXAt;
+    cmd.id = id;
+    cmd.x = x;
+    cmd.y = y;
+    cmd.value = volume;
+    cmd.priority = priority;
+    commands.push(cmd);
+}
+
+void AudioManager::update()
+{
+    if (!initialized || !voicesReady)
+    {
+        // Keep the queue from filling up while audio is unavailable
+        AudioCommand cmd;
+        while (commands.pop(cmd)) {}
         return;
+    }
+
+    for (float& v : pendingPlay)
+        v = -1.0f;
+
+    AudioCommand cmd;
+    while (commands.pop(cmd))
+    {
+        if (cmd.id == SfxId::Count && (cmd.type == AudioCommandType::PlaySFX ||
+                                       cmd.type == AudioCommandType::PlaySFXAt ||
+                                       cmd.type == AudioCommandType::StopSFX))
+            continue;
+
+        switch (cmd.type)
+        {
+            case AudioCommandType::PlaySFX: {
+                // Same sound several times this frame -> one voice at the loudest volume
+                float& pending = pendingPlay[static_cast<size_t>(cmd.id)];
+                pending = std::max(pending, cmd.value);
+                break;
+            }
+
+            case AudioCommandType::PlaySFXAt:
+                queueSpatial(cmd.id, cmd.x, cmd.y, cmd.value, cmd.priority);
+                break;
+
+            case AudioCommandType::StopSFX:
+                pendingPlay[static_cast<size_t>(cmd.id)] = -1.0f;
+                stopNow(cmd.id);
+                break;
+
+            case AudioCommandType::SetSFXVolume:
+                sfxVolume = std::clamp(cmd.value, 0.0f, 1.0f);
+                break;
+
+            case AudioCommandType::SetListener:
+                listenerX = cmd.x;
+                listenerY = cmd.y;
+                listenerAngle = cmd.value;
+                break;
+        }
+    }
+
+    for (size_t i = 0; i < SFX_COUNT; i++)
+        if (pendingPlay[i] >= 0.0f)
+            playNow(static_cast<SfxId>(i), pendingPlay[i]);
+
+    flushSpatial();
+}
+
+void AudioManager::stopNow(SfxId id)
+{
+    int bankIndex = static_cast<int>(id);
+
+    for (Voice& v : voices)
+        if (v.bank == bankIndex)
+            ma_sound_stop(&v.sound);
+}
 
-    auto it = sfx.find(name);
-    if (it == sfx.end())
+void AudioManager::playNow(SfxId id, float volume)
+{
+    int bankIndex = static_cast<int>(id);
+    const SfxBank& bank = banks[bankIndex];
+    if (!bank.pcm)
         return;
 
-    ma_sound* sound = &it->second;
+    Voice& v = voices[acquireVoice(bankIndex)];
+    startVoice(v, bankIndex, volume, 0.0f);
+    v.spatial = false;
+}
+
+void AudioManager::startVoice(Voice& v, int bankIndex, float volume, float pan)
+{
+    const SfxBank& bank = banks[bankIndex];
+
+    ma_sound_stop(&v.sound);
+    ma_audio_buffer_ref_set_data(&v.source, bank.pcm, bank.frameCount);
+
+    v.bank = bankIndex;
+    v.startedAt = ++playCounter;
 
-    ma_sound_set_volume(sound, volume);
-    ma_sound_seek_to_pcm_frame(sound, 0); // rewind
-    ma_sound_start(sound);
+    ma_sound_set_volume(&v.sound, volume * sfxVolume);
+    ma_sound_set_pan(&v.sound, pan);
+    ma_sound_seek_to_pcm_frame(&v.sound, 0); // rewind
+    ma_sound_start(&v.sound);
 }
 
-void AudioManager::playMusic(const std::string& path, bool loop)
+void AudioManager::queueSpatial(SfxId id, float x, float y, float volume, float priority)
 {
-    if (musicLoaded)
+    float dx = x - listenerX;
+    float dy = y - listenerY;
+    float dist = std::sqrt(dx * dx + dy * dy);
+
+    // Out of earshot, never queued
+    if (dist >= AUDIBLE_RADIUS)
+        return;
+
+    // Quadratic falloff between the full volume and audible radius
+    float t = (dist - FULL_VOLUME_RADIUS) / (AUDIBLE_RADIUS - FULL_VOLUME_RADIUS);
+    t = std::clamp(t, 0.0f, 1.0f);
+    float gain = volume * (1.0f - t) * (1.0f - t);
+
+    // Same camera-space X the renderer uses, so sounds pan toward where the sprite is drawn
+    float pan = 0.0f;
+    if (dist > 0.001f)
     {
-        ma_sound_stop(&music);
-        ma_sound_uninit(&music);
-        musicLoaded = false;
+        float sa = std::sin(listenerAngle);
+        float ca = std::cos(listenerAngle);
+        float camX = dx * (-sa) + dy * ca;
+        pan = std::clamp(camX / dist, -1.0f, 1.0f);
     }
 
+    float score = gain * priority;
+
+    // A horde of the same sound collapses into its loudest instance
+    for (int i = 0; i < pendingSpatialCount; i++)
+    {
+        SpatialRequest& req = pendingSpatial[i];
+        if (req.id != id)
+            continue;
+
+        if (score > req.score)
+            req = { id, gain, pan, score };
+        return;
+    }
+
+    // Queue full, replace the weakest request if this one beats it
+    if (pendingSpatialCount == MAX_SPATIAL_REQUESTS)
+    {
+        int weakest = 0;
+        for (int i = 1; i < pendingSpatialCount; i++)
+            if (pendingSpatial[i].score < pendingSpatial[weakest].score)
+                weakest = i;
+
+        if (pendingSpatial[weakest].score >= score)
+            return;
+
+        pendingSpatial[weakest] = { id, gain, pan, score };
+        return;
+    }
+
+    pendingSpatial[pendingSpatialCount++] = { id, gain, pan, score };
+}
+
+void AudioManager::flushSpatial()
+{
+    if (pendingSpatialCount == 0)
+        return;
+
+    // Loudest first so the cap keeps the ones that matter
+    std::sort(pendingSpatial, pendingSpatial + pendingSpatialCount,
+              [](const SpatialRequest& a, const SpatialRequest& b) { return a.score > b.score; });
+
+    int playingSpatial = 0;
+    for (Voice& v : voices)
+        if (v.spatial && ma_sound_is_playing(&v.sound))
+            playingSpatial++;
+
+    for (int i = 0; i < pendingSpatialCount; i++)
+    {
+        const SpatialRequest& req = pendingSpatial[i];
+        int bankIndex = static_cast<int>(req.id);
+        if (!banks[bankIndex].pcm)
+            continue;
+
+        Voice* target = nullptr;
+
+        if (playingSpatial < MAX_ENEMY_VOICES)
+        {
+            target = &voices[acquireVoice(bankIndex)];
+
+            // Only counts as new if it didn't steal another enemy voice
+            if (!(target->spatial && ma_sound_is_playing(&target->sound)))
+                playingSpatial++;
+        }
+        else
+        {
+            // Enemy voices capped, replace the quietest one if this is louder
+            for (Voice& v : voices)
+            {
+                if (!v.spatial || !ma_sound_is_playing(&v.sound))
+                    continue;
+                if (!target || v.score < target->score)
+                    target = &v;
+            }
+
+            // Sorted, so nothing after this can win either
+            if (!target || target->score >= req.score)
+                break;
+        }
+
+        startVoice(*target, bankIndex, req.gain, req.pan);
+        target->spatial = true;
+        target->score = req.score;
+    }
+
+    pendingSpatialCount = 0;
+}
+
+int AudioManager::findTrack(const std::string& path, TrackState state) const
+{
+    for (int i = 0; i < MAX_MUSIC_TRACKS; i++)
+        if (tracks[i].state == state && tracks[i].path == path)
+            return i;
+    return -1;
+}
+
+void AudioManager::releaseTrack(MusicTrack& t)
+{
+    if (t.state == TrackState::Empty)
+        return;
+
+    ma_sound_stop(&t.sound);
+    ma_sound_uninit(&t.sound);
+    t.path.clear();
+    t.state = TrackState::Empty;
+}
+
+void AudioManager::reclaimTracks()
+{
+    // Outgoing tracks are freed once their fade has run out
+    for (MusicTrack& t : tracks)
+        if (t.state == TrackState::FadingOut && !ma_sound_is_playing(&t.sound))
+            releaseTrack(t);
+}
+
+int AudioManager::openTrack(const std::string& path)
+{
+    reclaimTracks();
+
+    int slot = -1;
+    for (int i = 0; i < MAX_MUSIC_TRACKS && slot < 0; i++)
+        if (tracks[i].state == TrackState::Empty)
+            slot = i;
+
+    // Out of slots, drop an unused preload first, then cut a fade short
+    for (TrackState victim : { TrackState::Preloaded, TrackState::FadingOut })
+    {
+        for (int i = 0; i < MAX_MUSIC_TRACKS && slot < 0; i++)
+        {
+            if (tracks[i].state == victim)
+            {
+                releaseTrack(tracks[i]);
+                slot = i;
+            }
+        }
+    }
+
+    if (slot < 0)
+        return -1;
+
+    MusicTrack& t = tracks[slot];
+
     if (ma_sound_init_from_file(
             &engine,
             path.c_str(),
-            MA_SOUND_FLAG_STREAM,
+            MA_SOUND_FLAG_STREAM | MA_SOUND_FLAG_ASYNC, // decoder opens on a job thread
             nullptr,
             nullptr,
-            &music) != MA_SUCCESS)
+            &t.sound) != MA_SUCCESS)
     {
         std::cerr << "Failed to load music: " << path << "\n";
-        return;
+        return -1;
     }
 
-    ma_sound_set_looping(&music, loop ? MA_TRUE : MA_FALSE);
-    ma_sound_start(&music);
-    musicLoaded = true;
+    t.path = path;
+    t.state = TrackState::Preloaded;
+    return slot;
+}
+
+void AudioManager::preloadMusic(const std::string& path)
+{
+    if (!initialized)
+        return;
+
+    if (findTrack(path, TrackState::Preloaded) >= 0)
+        return;
+
+    openTrack(path);
 }
 
-void AudioManager::stopMusic()
+void AudioManager::playMusic(const std::string& path, bool loop, float fadeMs)
 {
-    if (!musicLoaded) return;
+    if (!initialized)
+        return;
+
+    // Fade the outgoing track on the audio thread
+    stopMusic(fadeMs);
+
+    int slot = findTrack(path, TrackState::Preloaded);
+    if (slot < 0)
+        slot = openTrack(path);
+    if (slot < 0)
+        return;
+
+    MusicTrack& t = tracks[slot];
+
+    ma_sound_set_looping(&t.sound, loop ? MA_TRUE : MA_FALSE);
+    ma_sound_set_fade_in_milliseconds(&t.sound, 0.0f, 1.0f, (ma_uint64)fadeMs);
+    ma_sound_start(&t.sound);
+
+    t.state = TrackState::Playing;
+    currentTrack = slot;
+}
 
-    ma_sound_stop(&music);
-    ma_sound_uninit(&music);
-    musicLoaded = false;
+void AudioManager::stopMusic(float fadeMs)
+{
+    if (currentTrack < 0)
+        return;
+
+    MusicTrack& t = tracks[currentTrack];
+    currentTrack = -1;
+
+    if (fadeMs <= 0.0f)
+    {
+        releaseTrack(t);
+        return;
+    }
+
+    ma_sound_stop_with_fade_in_milliseconds(&t.sound, (ma_uint64)fadeMs);
+    t.state = TrackState::FadingOut;
 }
 
 void AudioManager::shutdown()
@@ -100,20 +501,27 @@ void AudioManager::shutdown()
     ma_engine_stop(&engine);
 
     // Stop & uninit music
-    if (musicLoaded)
+    for (MusicTrack& t : tracks)
+        releaseTrack(t);
+    currentTrack = -1;
+
+    // Uninit voices, then free the decoded banks they point at
+    if (voicesReady)
     {
-        ma_sound_stop(&music);
-        ma_sound_uninit(&music);
-        musicLoaded = false;
+        for (Voice& v : voices)
+        {
+            ma_sound_stop(&v.sound);
+            ma_sound_uninit(&v.sound);
+            ma_audio_buffer_ref_uninit(&v.source);
+        }
+        voicesReady = false;
     }
 
-    // Uninit SFX
-    for (auto& [name, sound] : sfx)
+    for (SfxBank& bank : banks)
     {
-        ma_sound_stop(&sound);
-        ma_sound_uninit(&sound);
+        ma_free(bank.pcm, nullptr);
+        bank = SfxBank{};
     }
-    sfx.clear();
 
     ma_engine_uninit(&engine);
 }
@@ -1,8 +1,10 @@
 #pragma once
 
 #include "../third_party/miniaudio.h"
+#include "SfxId.h"
+#include "AudioCommandQueue.h"
 #include <string>
-#include <unordered_map>
+#include <cstdint>
 
 class AudioManager
 {
@@ -11,23 +13,116 @@ public:
     void shutdown();
 
     // Music
-    void playMusic(const std::string& path, bool loop = true);
-    void stopMusic();
+    // Tracks stream from disk and open on miniaudio's job thread, so none
+    // of these block. playMusic crossfades from whatever is playing.
+    void preloadMusic(const std::string& path);
+    void playMusic(const std::string& path, bool loop = true, float fadeMs = MUSIC_FADE_MS);
+    void stopMusic(float fadeMs = 0.0f);
 
     // Sound Effects
-    void loadSFX(const std::string& name, const std::string& path);
-    void playSFX(const std::string& name, float volume = 1.0f);
+    // Decodes the whole file into memory once. maxVoices caps how many
+    // copies of this sound may overlap before the oldest one is stolen.
+    void loadSFX(SfxId id, const std::string& path, int maxVoices = 4);
+
+    // The SFX calls below only enqueue a command and are safe from any
+    // thread. Nothing reaches miniaudio until update() drains the queue.
+    void playSFX(SfxId id, float volume = 1.0f);
+    void stopSFX(SfxId id);
+    void setSFXVolume(float volume);
+
+    // Positional SFX (enemies)
+    // Set once per frame from the player before anything calls playSFXAt.
+    void setListener(float x, float y, float angle);
+
+    // World-space sound. At drain time only the loudest requests survive.
+    void playSFXAt(SfxId id, float x, float y, float volume = 1.0f, float priority = 1.0f);
+
+    // Main thread, once per frame. Drains queued commands, collapses
+    // repeats of the same sound and starts the survivors.
+    void update();
 
 private:
     ma_engine engine{};
 
     // Music
-    ma_sound music{};
-    bool musicLoaded = false;
+    static constexpr float MUSIC_FADE_MS = 600.0f;
+    static constexpr int MAX_MUSIC_TRACKS = 4;
+
+    enum class TrackState { Empty, Preloaded, Playing, FadingOut };
+
+    struct MusicTrack {
+        ma_sound sound{};
+        std::string path;
+        TrackState state = TrackState::Empty;
+    };
+
+    MusicTrack tracks[MAX_MUSIC_TRACKS];
+    int currentTrack = -1;
+
+    int openTrack(const std::string& path);
+    int findTrack(const std::string& path, TrackState state) const;
+    void reclaimTracks();
+    void releaseTrack(MusicTrack& t);
 
     bool initialized = false;
 
-    // Sound effects
-    std::unordered_map<std::string, ma_sound> sfx;
-};
+    // Decoded PCM for one SFX (f32, engine channels / sample rate)
+    struct SfxBank {
+        void* pcm = nullptr; // null until loaded
+        ma_uint64 frameCount = 0;
+        int maxVoices = 4;
+    };
+
+    // One playback slot. The sound is created once at init and
+    // re-pointed at a bank on every play, so playing never allocates.
+    struct Voice {
+        ma_audio_buffer_ref source{};
+        ma_sound sound{};
+        int bank = -1;
+        uint64_t startedAt = 0;
+        bool spatial = false;
+        float score = 0.0f; // gain * priority when started (spatial only)
+    };
 
+    // A positional play waiting for flushSpatial()
+    struct SpatialRequest {
+        SfxId id;
+        float gain;
+        float pan;
+        float score;
+    };
+
+    static constexpr int MAX_VOICES = 32;
+
+    // Spatial tuning (distances in tiles)
+    static constexpr float AUDIBLE_RADIUS = 14.0f;
+    static constexpr float FULL_VOLUME_RADIUS = 1.5f;
+    static constexpr int MAX_ENEMY_VOICES = 8;
+    static constexpr int MAX_SPATIAL_REQUESTS = 32;
+
+    SfxBank banks[SFX_COUNT];
+
+    Voice voices[MAX_VOICES];
+    bool voicesReady = false;
+    uint64_t playCounter = 0;
+
+    float listenerX = 0.0f;
+    float listenerY = 0.0f;
+    float listenerAngle = 0.0f;
+
+    SpatialRequest pendingSpatial[MAX_SPATIAL_REQUESTS];
+    int pendingSpatialCount = 0;
+
+    AudioCommandQueue commands;
+
+    // Per-drain dedupe of plain plays: loudest requested volume, < 0 = none
+    float pendingPlay[SFX_COUNT];
+    float sfxVolume = 1.0f;
+
+    int acquireVoice(int bank);
+    void startVoice(Voice& v, int bank, float volume, float pan);
+    void playNow(SfxId id, float volume);
+    void stopNow(SfxId id);
+    void queueSpatial(SfxId id, float x, float y, float volume, float priority);
+    void flushSpatial();
+};
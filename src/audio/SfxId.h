@@ -0,0 +1,128 @@
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+
+// Every sound effect the game knows about. Call sites pass these to
+// AudioManager::playSFX, so a misspelled sound no longer compiles.
+enum class SfxId {
+    // Menus
+    MenuUp,
+    MenuEnter,
+    LvlEndWordsCollide,
+    GameOverOOF,
+
+    // Player / world
+    WallSlide,
+    Walk,
+    Jump,
+    LavaBurn,
+
+    // Pickups
+    GunPickup,
+    HealPickup,
+    ArmorPickup,
+    AmmoPickup,
+
+    // Weapons
+    GunClick,
+    ItemSwap,
+    PistolShoot,
+    PistolReload,
+    ShotgunShoot,
+    ShotgunReload,
+    MgShoot,
+    MgReload,
+
+    // Enemy attacks
+    BaseAttack,
+    TankAttack,
+    ShooterAttack,
+    FastAttack,
+
+    // Enemy deaths
+    ZombieDeadBase,
+    ZombieDeadFast,
+    ZombieDeadShooter,
+    ZombieDeadTank,
+
+    // Enemy idle
+    ZombieIdleBase,
+    ZombieIdleFast,
+    ZombieIdleShooter,
+    ZombieIdleTank,
+
+    // Enemy chase
+    ZombieChaseBase,
+    ZombieChaseFast,
+    ZombieChaseShooter,
+    ZombieChaseTank,
+
+    Count
+};
+
+constexpr size_t SFX_COUNT = static_cast<size_t>(SfxId::Count);
+
+// Debug names, indexed by SfxId (used for load errors and name lookups)
+constexpr std::string_view SFX_NAMES[SFX_COUNT] = {
+    "menu_up",
+    "menu_enter",
+    "lvlEnd_wordsCollide",
+    "GameOverOOF",
+
+    "wall_slide",
+    "walk",
+    "jump",
+    "lava_burn",
+
+    "gun_pickup",
+    "heal_pickup",
+    "armor_pickup",
+    "ammo_pickup",
+
+    "gun_click",
+    "item_swap",
+    "pistol_shoot",
+    "pistol_reload",
+    "shotgun_shoot",
+    "shotgun_reload",
+    "mg_shoot",
+    "mg_reload",
+
+    "base_attack",
+    "tank_attack",
+    "shooter_attack",
+    "fast_attack",
+
+    "zombie_dead_base",
+    "zombie_dead_fast",
+    "zombie_dead_shooter",
+    "zombie_dead_tank",
+
+    "zombie_idle_base",
+    "zombie_idle_fast",
+    "zombie_idle_shooter",
+    "zombie_idle_tank",
+
+    "zombie_chase_base",
+    "zombie_chase_fast",
+    "zombie_chase_shooter",
+    "zombie_chase_tank",
+};
+
+constexpr std::string_view sfxName(SfxId id)
+{
+    return SFX_NAMES[static_cast<size_t>(id)];
+}
+
+// Reverse lookup for anything still holding a string (cold path only)
+constexpr SfxId sfxFromName(std::string_view name)
+{
+    for (size_t i = 0; i < SFX_COUNT; i++)
+        if (SFX_NAMES[i] == name)
+            return static_cast<SfxId>(i);
+    return SfxId::Count;
+}
+
+static_assert(sfxFromName("zombie_chase_tank") == SfxId::ZombieChaseTank,
+              "SFX_NAMES out of sync with SfxId");
@@ -16,6 +16,7 @@
 #include <SDL2/SDL.h>
 #include <iostream>
 #include <memory>
+#include <future>
 
 int SCREEN_WIDTH = 1200;
 int SCREEN_HEIGHT = 900;
@@ -45,50 +46,51 @@ int main() {
     AudioManager audio;
     audio.init();
 
-    audio.loadSFX("menu_up", "Assets/audio/menu_up.mp3");
-    audio.loadSFX("menu_enter", "Assets/audio/menu_enter.mp3");
-
-    audio.loadSFX("lvlEnd_wordsCollide", "Assets/audio/lvlEnd_wordsCollide.mp3");
-    audio.loadSFX("GameOverOOF", "Assets/audio/GameOverOOF.mp3");
-
-    audio.loadSFX("wall_slide", "Assets/audio/wall_slide.mp3");
-    audio.loadSFX("walk", "Assets/audio/walk1.mp3");
-    audio.loadSFX("jump", "Assets/audio/jump.mp3");
-
-    audio.loadSFX("gun_pickup", "Assets/audio/gun_pickup.mp3");
-    audio.loadSFX("heal_pickup", "Assets/audio/heal_pickup.mp3");
-    audio.loadSFX("armor_pickup", "Assets/audio/armor_pickup.mp3");
-    audio.loadSFX("ammo_pickup", "Assets/audio/ammo_pickup.mp3");
-
-    audio.loadSFX("gun_click", "Assets/audio/gun_click.mp3");
-    audio.loadSFX("item_swap", "Assets/audio/item_swap.mp3");
-    audio.loadSFX("pistol_shoot", "Assets/audio/pistol_shoot.mp3");
-    audio.loadSFX("pistol_reload", "Assets/audio/pistol_reload.mp3");
-    audio.loadSFX("shotgun_shoot", "Assets/audio/shotgun_shoot.mp3");
-    audio.loadSFX("shotgun_reload", "Assets/audio/shotgun_reload.mp3");
-    audio.loadSFX("mg_shoot", "Assets/audio/mg_shoot.mp3");
-    audio.loadSFX("mg_reload", "Assets/audio/mg_reload.mp3");
-
-    audio.loadSFX("base_attack", "Assets/audio/base_attack.mp3");
-    audio.loadSFX("tank_attack", "Assets/audio/tank_attack.mp3");
-    audio.loadSFX("shooter_attack", "Assets/audio/shooter_attack.mp3");
-    audio.loadSFX("fast_attack", "Assets/audio/fast_attack.mp3");
-    audio.loadSFX("lava_burn", "Assets/audio/lava_burn.mp3");
-
-    audio.loadSFX("zombie_dead_base", "Assets/audio/zombie_dead_base.mp3");
-    audio.loadSFX("zombie_dead_fast", "Assets/audio/zombie_dead_fast.mp3");
-    audio.loadSFX("zombie_dead_shooter", "Assets/audio/zombie_dead_shooter.mp3");
-    audio.loadSFX("zombie_dead_tank", "Assets/audio/zombie_dead_tank.mp3");
-
-    audio.loadSFX("zombie_idle_base", "Assets/audio/zombie_idle_base.mp3");
-    audio.loadSFX("zombie_idle_fast", "Assets/audio/zombie_idle_fast.mp3");
-    audio.loadSFX("zombie_idle_shooter", "Assets/audio/zombie_idle_shooter.mp3");
-    audio.loadSFX("zombie_idle_tank", "Assets/audio/zombie_idle_tank.mp3");
-
-    audio.loadSFX("zombie_chase_base", "Assets/audio/zombie_chase_base.mp3");
-    audio.loadSFX("zombie_chase_fast", "Assets/audio/zombie_chase_fast.mp3");
-    audio.loadSFX("zombie_chase_shooter", "Assets/audio/zombie_chase_shooter.mp3");
-    audio.loadSFX("zombie_chase_tank", "Assets/audio/zombie_chase_tank.mp3");
+    // Last arg caps overlapping voices per sound (default 4)
+    audio.loadSFX(SfxId::MenuUp, "Assets/audio/menu_up.mp3", 1);
+    audio.loadSFX(SfxId::MenuEnter, "Assets/audio/menu_enter.mp3", 1);
+
+    audio.loadSFX(SfxId::LvlEndWordsCollide, "Assets/audio/lvlEnd_wordsCollide.mp3", 1);
+    audio.loadSFX(SfxId::GameOverOOF, "Assets/audio/GameOverOOF.mp3", 1);
+
+    audio.loadSFX(SfxId::WallSlide, "Assets/audio/wall_slide.mp3", 1);
+    audio.loadSFX(SfxId::Walk, "Assets/audio/walk1.mp3", 1);
+    audio.loadSFX(SfxId::Jump, "Assets/audio/jump.mp3", 1);
+
+    audio.loadSFX(SfxId::GunPickup, "Assets/audio/gun_pickup.mp3");
+    audio.loadSFX(SfxId::HealPickup, "Assets/audio/heal_pickup.mp3");
+    audio.loadSFX(SfxId::ArmorPickup, "Assets/audio/armor_pickup.mp3");
+    audio.loadSFX(SfxId::AmmoPickup, "Assets/audio/ammo_pickup.mp3");
+
+    audio.loadSFX(SfxId::GunClick, "Assets/audio/gun_click.mp3", 1);
+    audio.loadSFX(SfxId::ItemSwap, "Assets/audio/item_swap.mp3", 1);
+    audio.loadSFX(SfxId::PistolShoot, "Assets/audio/pistol_shoot.mp3");
+    audio.loadSFX(SfxId::PistolReload, "Assets/audio/pistol_reload.mp3", 1);
+    audio.loadSFX(SfxId::ShotgunShoot, "Assets/audio/shotgun_shoot.mp3");
+    audio.loadSFX(SfxId::ShotgunReload, "Assets/audio/shotgun_reload.mp3", 1);
+    audio.loadSFX(SfxId::MgShoot, "Assets/audio/mg_shoot.mp3", 8);
+    audio.loadSFX(SfxId::MgReload, "Assets/audio/mg_reload.mp3", 1);
+
+    audio.loadSFX(SfxId::BaseAttack, "Assets/audio/base_attack.mp3");
+    audio.loadSFX(SfxId::TankAttack, "Assets/audio/tank_attack.mp3");
+    audio.loadSFX(SfxId::ShooterAttack, "Assets/audio/shooter_attack.mp3");
+    audio.loadSFX(SfxId::FastAttack, "Assets/audio/fast_attack.mp3");
+    audio.loadSFX(SfxId::LavaBurn, "Assets/audio/lava_burn.mp3", 1);
+
+    audio.loadSFX(SfxId::ZombieDeadBase, "Assets/audio/zombie_dead_base.mp3");
+    audio.loadSFX(SfxId::ZombieDeadFast, "Assets/audio/zombie_dead_fast.mp3");
+    audio.loadSFX(SfxId::ZombieDeadShooter, "Assets/audio/zombie_dead_shooter.mp3");
+    audio.loadSFX(SfxId::ZombieDeadTank, "Assets/audio/zombie_dead_tank.mp3");
+
+    audio.loadSFX(SfxId::ZombieIdleBase, "Assets/audio/zombie_idle_base.mp3");
+    audio.loadSFX(SfxId::ZombieIdleFast, "Assets/audio/zombie_idle_fast.mp3");
+    audio.loadSFX(SfxId::ZombieIdleShooter, "Assets/audio/zombie_idle_shooter.mp3");
+    audio.loadSFX(SfxId::ZombieIdleTank, "Assets/audio/zombie_idle_tank.mp3");
+
+    audio.loadSFX(SfxId::ZombieChaseBase, "Assets/audio/zombie_chase_base.mp3");
+    audio.loadSFX(SfxId::ZombieChaseFast, "Assets/audio/zombie_chase_fast.mp3");
+    audio.loadSFX(SfxId::ZombieChaseShooter, "Assets/audio/zombie_chase_shooter.mp3");
+    audio.loadSFX(SfxId::ZombieChaseTank, "Assets/audio/zombie_chase_tank.mp3");
 
     // Load geometry textures
     TextureManager textures;
@@ -106,6 +108,9 @@ int main() {
     GameState gameState = GameState::StudioIntro;
     std::unique_ptr<GameSession> session = nullptr;
 
+    // Next session, prepared in the background while the main menu is shown
+    std::future<std::unique_ptr<GameSession>> pendingSession;
+
     // Game Difficulty
     Difficulty difficulty = Difficulty::Medium;
 
@@ -126,8 +131,8 @@ int main() {
         // -------------------------
         if (gameState == GameState::StudioIntro) {
 
-            audio.stopMusic();
-            audio.playMusic(resolvePath("Assets/audio/IntroJingle.mp3"), false);
+            audio.playMusic(resolvePath("Assets/audio/IntroJingle.mp3"), false, 0.0f);
+            audio.preloadMusic(resolvePath("Assets/audio/FurySyrgeMainTheme.mp3"));
 
             studioIntro.start();
 
@@ -136,6 +141,9 @@ int main() {
                 float dt = (now - last) / 1000.f;
                 last = now;
 
+                // Play the sounds queued during the previous frame
+                audio.update();
+
                 SDL_Event e;
                 while (SDL_PollEvent(&e)) {
                     if (e.type == SDL_QUIT) {
@@ -156,14 +164,24 @@ int main() {
         // -------------------------
         if (gameState == GameState::MainMenu) {
 
-            audio.stopMusic();
             audio.playMusic(resolvePath("Assets/audio/FurySyrgeMainTheme.mp3"), true);
+            audio.preloadMusic(resolvePath("Assets/audio/FurySyrgeLVL1Theme.mp3"));
+
+            // Start preparing the next game session so Start is instant
+            if (!session && !pendingSession.valid()) {
+                pendingSession = std::async(std::launch::async, [] {
+                    return std::make_unique<GameSession>(SCREEN_WIDTH, SCREEN_HEIGHT);
+                });
+            }
 
             while (running && gameState == GameState::MainMenu) {
                 Uint32 now = SDL_GetTicks();
                 float dt = (now - last) / 1000.f;
                 last = now;
 
+                // Play the sounds queued during the previous frame
+                audio.update();
+
                 SDL_Event e;
                 while (SDL_PollEvent(&e)) {
                     if (e.type == SDL_QUIT) {
@@ -174,14 +192,16 @@ int main() {
                     mainMenu.handleInput(e, gameState, running, mainRun, difficulty, audio);
                 }
 
-                // Start game and create new game session
-                if (gameState == GameState::Playing && !session) {
-                    session = std::make_unique<GameSession>(
-                        renderer,
-                        SCREEN_WIDTH,
-                        SCREEN_HEIGHT,
-                        difficulty
-                    );
+                // Start game: finalize the preloaded session the first time,
+                // afterwards reuse it and only reset the run state
+                if (gameState == GameState::Playing) {
+                    if (!session) {
+                        session = pendingSession.get();
+                        session->finalize(renderer, difficulty);
+                    }
+                    else {
+                        session->resetForNewRun(difficulty);
+                    }
                 }
 
                 mainMenu.updateCursor(dt);
@@ -195,20 +215,25 @@ int main() {
         // -------------------------
         else if (gameState == GameState::Playing && session) {
 
-            audio.stopMusic();
             audio.playMusic(resolvePath("Assets/audio/FurySyrgeLVL1Theme.mp3"), true);
 
+            // Open the end-of-level stingers now so the switch is seamless
+            audio.preloadMusic(resolvePath("Assets/audio/FurySyrgeLvlComplete.mp3"));
+            audio.preloadMusic(resolvePath("Assets/audio/GameOver.mp3"));
+
             while (running && gameState != GameState::MainMenu) {
                 Uint32 now = SDL_GetTicks();
                 float dt = (now - last) / 1000.f;
                 last = now;
 
+                // Play the sounds queued during the previous frame
+                audio.update();
+
                 // -------------------------
                 // LEVEL END
                 // -------------------------
                 if (gameState == GameState::LevelEnd) {
                     if (!levelEnd.startedMusic) {
-                        audio.stopMusic();   
                         audio.playMusic(resolvePath("Assets/audio/FurySyrgeLvlComplete.mp3"), false);
                         levelEnd.startedMusic = true;
                     }
@@ -225,7 +250,6 @@ int main() {
                     levelEnd.update(dt, gameState, audio);
 
                     if (gameState == GameState::MainMenu && session) {
-                        session.reset();
                         levelEnd.startedMusic = false;
                         levelEnd.resetAnimation();
                         break;
@@ -241,9 +265,9 @@ int main() {
                 if (gameState == GameState::PlayerDead)
                 {
                     if (!gameOver.startedMusic) {
-                        audio.stopMusic();
                         audio.playMusic(resolvePath("Assets/audio/GameOver.mp3"), false);
-                        audio.playSFX("GameOverOOF");
+                        audio.playSFX(SfxId::GameOverOOF);
+                        audio.preloadMusic(resolvePath("Assets/audio/FurySyrgeLVL1Theme.mp3"));
                         gameOver.startedMusic = true;
                     }
 
@@ -260,11 +284,21 @@ int main() {
                     gameOver.update(dt, gameState);
 
                     if (gameState == GameState::MainMenu && session) {
-                        session.reset();
                         gameOver.startedMusic = false;
                         gameOver.reset();
                         break;
                     }
+
+                    // Retry wave, falls back to a fresh run if no wave started yet
+                    if (gameState == GameState::Playing && session) {
+                        if (!session->retryWave())
+                            session->resetForNewRun(difficulty);
+
+                        gameOver.reset();
+
+                        audio.playMusic(resolvePath("Assets/audio/FurySyrgeLVL1Theme.mp3"), true);
+                        continue;
+                    }
                     if (session) {
                         session->render(renderer, pixels, SCREEN_WIDTH, SCREEN_HEIGHT, textures);
                     }
@@ -322,9 +356,8 @@ int main() {
                         pauseMenu.handleInput(e, gameState, running, audio);
                     }
 
-                    // Exit to menu, destroy current game session
+                    // Exit to menu, session is kept and reset on the next Start
                     if (gameState == GameState::MainMenu) {
-                        session.reset();
                         pauseT = 0.0f;
 
                         // Restore clean renderer state
@@ -368,7 +401,7 @@ int main() {
 
                     const Uint8* keys = SDL_GetKeyboardState(nullptr);
 
-                    session->update(dt, keys, gameState, audio);
+                    session->advance(dt, keys, gameState, audio);
                     session->render(renderer, pixels, SCREEN_WIDTH, SCREEN_HEIGHT, textures);
                 }
             }